@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/*
+Benchmark harness: runs every script of a corpus under each engine of
+brainduck and prints one JSON object per line for each pair, holding
+the best wall time of a few runs, the instructions run per second and
+the peak resident set size.
+
+    bench/bench ./brainduck bench/corpus.txt [runs]
+
+Each line of the corpus holds a script, the file its input is read from
+('-' for none) and any options it needs. The number of instructions is
+the one --profile reports for the script, which is the same whichever
+engine runs it, so instructions per second compare across engines.
+Where the JIT would fall back to the bytecode interpreter, because the
+script needs wider cells or the platform has no JIT, its line is marked
+as skipped instead of timing the interpreter under its name.
+*/
+
+#define CORPUS_LINE 4096 // longest corpus line
+#define MAX_ARGS 32 // most options of a script
+#define DEFAULT_RUNS 3
+
+/* Ways brainduck can run a script, and the option selecting each */
+static const char* engines[][2] = {
+    {"naive", "--naive"},
+    {"bytecode", "--no-optimize"},
+    {"optimized", NULL},
+    {"jit", "--jit"}
+};
+
+#define JIT_ENGINE 3 // index of the JIT in engines
+
+typedef struct result {
+    int status; // exit code of the last run
+    double seconds; // best wall time
+    long max_rss; // in kilobytes, the highest of all runs
+} Result;
+
+/*
+Runs brainduck with the given arguments, input from the file input and
+output to out, a descriptor. Returns the exit code, or -1 if it could
+not be run, and fills in the time taken and the peak memory use.
+*/
+static int run(char** args, const char* input, int out, double* seconds, long* max_rss){
+    struct timespec start, end;
+    struct rusage usage;
+    int status = 0;
+    pid_t pid;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0){
+        int in = open(strcmp(input, "-") == 0 ? "/dev/null" : input, O_RDONLY);
+        if (in < 0) _exit(127);
+        dup2(in, STDIN_FILENO);
+        dup2(out, STDOUT_FILENO);
+        execv(args[0], args);
+        _exit(127);
+    }
+    if (wait4(pid, &status, 0, &usage) < 0) return -1;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    *max_rss = usage.ru_maxrss;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* Counts the instructions a script runs, from its --profile=json report. Returns 0 if unknown */
+static unsigned long long count_instructions(char** args, int argc, const char* input){
+    static const char key[] = "{\"instructions\": ";
+    char* report = NULL;
+    size_t len = 0;
+    unsigned long long count = 0;
+    double seconds;
+    long max_rss;
+    FILE* file = tmpfile();
+    char* found = NULL;
+    char* p;
+
+    if (!file) return 0;
+    args[argc] = "--profile=json";
+    args[argc + 1] = NULL;
+    run(args, input, fileno(file), &seconds, &max_rss);
+    args[argc] = NULL;
+
+    // the report comes after the output of the script, so the last match is the one
+    len = (size_t)ftell(file);
+    report = malloc(len + 1);
+    rewind(file);
+    if (report && fread(report, 1, len, file) == len){
+        report[len] = '\0';
+        for(p = report; (p = memmem(p, len - (size_t)(p - report), key, sizeof(key) - 1)); ++p) found = p;
+        if (found) count = strtoull(found + sizeof(key) - 1, NULL, 10);
+    }
+    free(report);
+    fclose(file);
+    return count;
+}
+
+/*
+Returns why the JIT would not run a script given its options, or NULL
+if it would. Mirrors the checks of jit_compile, which falls back to
+the bytecode interpreter silently.
+*/
+static const char* jit_skipped(char** args, int argc){
+#if defined(__x86_64__) && defined(__unix__)
+    int wide = 0;
+    int i;
+    for(i = 2; i < argc; ++i){
+        if (strncmp(args[i], "--cell-bits=", 12) == 0) wide = strcmp(args[i] + 12, "8") != 0;
+    }
+    return wide ? "the JIT only handles 8-bit cells" : NULL;
+#else
+    (void)args;
+    (void)argc;
+    return "no JIT on this platform";
+#endif
+}
+
+/* Runs a script under one engine, keeping the best time */
+static Result bench(char** args, const char* input, int runs){
+    Result result = {0, 0.0, 0};
+    int out = open("/dev/null", O_WRONLY);
+    int i;
+    for(i = 0; i < runs; ++i){
+        double seconds = 0.0;
+        long max_rss = 0;
+        result.status = run(args, input, out, &seconds, &max_rss);
+        if (i == 0 || seconds < result.seconds) result.seconds = seconds;
+        if (max_rss > result.max_rss) result.max_rss = max_rss;
+    }
+    if (out >= 0) close(out);
+    return result;
+}
+
+int main(int argc, char* argv[]){
+    char line[CORPUS_LINE];
+    long number = 0;
+    int runs = (argc > 3) ? atoi(argv[3]) : DEFAULT_RUNS;
+    FILE* corpus;
+
+    if (argc < 3 || runs <= 0){
+        printf("Usage: %s BRAINDUCK CORPUS [RUNS]\n", argv[0]);
+        return 1;
+    }
+    corpus = fopen(argv[2], "r");
+    if (!corpus){
+        printf("Error: Unable to open file '%s'\n", argv[2]);
+        return 1;
+    }
+
+    while(fgets(line, sizeof(line), corpus)){
+        char* args[MAX_ARGS + 4];
+        char* script, *input, *word;
+        unsigned long long instructions;
+        int count = 0;
+        size_t e;
+
+        number++;
+        script = strtok(line, " \t\r\n");
+        if (!script || *script == '#') continue;
+        input = strtok(NULL, " \t\r\n");
+        if (!input){
+            printf("Error: no input on line %ld of '%s'\n", number, argv[2]);
+            fclose(corpus);
+            return 1;
+        }
+        args[count++] = argv[1];
+        args[count++] = script;
+        while((word = strtok(NULL, " \t\r\n")) && count < MAX_ARGS) args[count++] = word;
+        args[count] = NULL;
+
+        instructions = count_instructions(args, count, input);
+        for(e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e){
+            const char* skipped = (e == JIT_ENGINE) ? jit_skipped(args, count) : NULL;
+            Result result;
+            if (skipped){
+                printf("{\"script\": \"%s\", \"engine\": \"%s\", \"skipped\": \"%s\"}\n",
+                       script, engines[e][0], skipped);
+                fflush(stdout);
+                continue;
+            }
+            args[count] = (char*)engines[e][1];
+            args[count + 1] = NULL;
+            result = bench(args, input, runs);
+            printf("{\"script\": \"%s\", \"engine\": \"%s\", \"status\": %d, \"seconds\": %.6f, "
+                   "\"instructions\": %llu, \"instructions_per_second\": %.0f, \"max_rss_kb\": %ld}\n",
+                   script, engines[e][0], result.status, result.seconds, instructions,
+                   result.seconds > 0 ? (double)instructions / result.seconds : 0.0, result.max_rss);
+            fflush(stdout);
+        }
+        args[count] = NULL;
+    }
+    fclose(corpus);
+    return 0;
+}
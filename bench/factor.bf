@@ -0,0 +1,129 @@
+( Factorisation
+  Prints every number from 2 to 300 followed by its prime factors,
+  found by trial division up to the square root of what is left.
+  Needs 16-bit cells )
+
+>[-]+<[-]+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++[->+>>>>>>>>
+>>>>>[-]>>[-]<<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<[-]>[-]>>[-]<<<<[->>+>>+<<<<]>>>>[-<<<<+>>>>]<[
+-]++++++++++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<+>>[-]+
++++++++++>[-]]<<]<<<<<<<[-]++++++++++>>>>>>>>[-<<<<<<<<->>>>>>>>]<<<[-]>>>[-]<<[
+-<+>>>+<<]>>[-<<+>>]<<[-]>>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<<[-]++++++++
+++>[-<->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<+>[-]+++++
++++++>>[-]]<]<<<<<<<[-]++++++++++>>>>>>[-<<<<<<->>>>>>]<<[-]>>[-]<[-<+>>+<]>[-<+
+>]<[-]>[-]>>[-]<<<<[->>+>>+<<<<]>>>>[-<<<<+>>>>]<[-]++++++++++<[->->[-]+>[-]>[-]
+<<<[->>+>+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<+>>[-]++++++++++>[-]]<<]<<<<<[-]+++++
++++++>>>>>>[-<<<<<<->>>>>>]<<<[-]>>>[-]<<[-<+>>>+<<]>>[-<<+>>]<<[-]>>[-]>[-]<<<<
+[->>>+>+<<<<]>>>>[-<<<<+>>>>]<<[-]++++++++++>[-<->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]
+>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<+>[-]++++++++++>>[-]]<]<<<<<[-]++++++++++>>>>[-<
+<<<->>>>]<<[-]>>[-]<[-<+>>+<]>[-<+>]<[-]>[-]>>[-]<<<<[->>+>>+<<<<]>>>>[-<<<<+>>>
+>]<[-]++++++++++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<+>>
+[-]++++++++++>[-]]<<]<<<[-]++++++++++>>>>[-<<<<->>>>]<<<[-]>>>[-]<<[-<+>>>+<<]>>
+[-<<+>>][-]<[-]>>[-]<<<<<[->>>+>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<[>[-]+<[-]][-]>>[-]
+<[-<+>>+<]>[-<+>]<<[<<<++++++++++++++++++++++++++++++++++++++++++++++++.--------
+---------------------------------------->>>[-]][-]>>[-]<<<<<<[->>>>+>>+<<<<<<]>>
+>>>>[-<<<<<<+>>>>>>]<<[>[-]+<[-]][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<+++++++++++++++
++++++++++++++++++++++++++++++++++.----------------------------------------------
+-->>>>[-]][-]>>[-]<<<<<<<[->>>>>+>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<[>[-]+<[-
+]][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<<+++++++++++++++++++++++++++++++++++++++++++++
++++.------------------------------------------------>>>>>[-]][-]>>[-]<<<<<<<<[->
+>>>>>+>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<[>[-]+<[-]][-]>>[-]<[-<+>>+<]>[-
+<+>]<<[<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++.------------------
+------------------------------>>>>>>[-]]<<<<<<<+++++++++++++++++++++++++++++++++
++++++++++++++++.------------------------------------------------[-]>[-]>[-]>[-]>
+[-]>[-]>[-]>>[-][-]++++++++++++++++++++++++++++++++++++++++++++++++++++++++++.[-
+]<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<[->+>>>>>>>>>>>>>>>+<<<<<<<
+<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<[-]+
++>>[-]+[<[-]>>>>>>>>>>>>>[-]<<[-]<<<<<<<<<<<<[->>>>>>>>>>>>>>+<<+<<<<<<<<<<<<]>>
+>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>>[-<<[-]<<<<<<<<<<<<[->+>>>>>>>>>>>+<<<<<
+<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>>][-]<<<<[-]<<<<<<<<<[->>>>>>>>
+>>>>>+<<<<+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]>>[-]<<[-]<<<<<<<<<<<[->>>>>
+>>>>>>>>+<<+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]>[-]<[-]<[-]>>>>>[-
+<<<<+<+>>>>>]<<<<<[->>>>>+<<<<<]>[<[-]<[-]>>>>[-<<<+<+>>>>]<<<<[->>>>+<<<<]>[>>[
+-]+<<[-]]>[-]]>[>>>-<<-<[-]<[-]<[-]>>>>>[-<<<<+<+>>>>>]<<<<<[->>>>>+<<<<<]>[<[-]
+<[-]>>>>[-<<<+<+>>>>]<<<<[->>>>+<<<<]>[>>[-]+<<[-]]>[-]]>]<<<<<<<<[-]>>>>>>>[-]<
+[-]>>>>>[-<<<<+<+>>>>>]<<<<<[->>>>>+<<<<<]>[<<<<<<<[-]+>>>>>>>[-]]>>>>[-]<<[-]<[
+-]+>[-]>>[-]<<<<<<<<<<<[->>>>>>>>>+>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>
+>>>>>>]<<[<[-]>>>[-]++++++++++++++++++++++++++++++++.[-]<<<<<<<<[-]>>>>>>>>>[-]<
+<<<<<<<<<<<<<<<[->>>>>>>+>>>>>>>>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<<<+>>>>>>>>>>>>>>>>]<<[-]>>[-]>>[-]<<<<<<<<<<<[->>>>>>>>>+>>+<<<<<<<<<<<]>>>
+>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<[-]++++++++++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]
+>>>[-<<<+>>>]<[<[-]>[-]]<[<<<<+>>>[-]++++++++++>[-]]<<]<[-]++++++++++>>[-<<->>]<
+<<<<<<<<<[-]>>>>>>>>>>[-]<<<[-<<<<<<<+>>>>>>>>>>+<<<]>>>[-<<<+>>>]<<<[-]>>>[-]>[
+-]<<<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<[
+-]++++++++++>[-<->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<
+<+>>[-]++++++++++>>[-]]<]<<<<<<[-]++++++++++>>>>>[-<<<<<->>>>>]<<<<<<<<<[-]>>>>>
+>>>>[-]<<[-<<<<<<<+>>>>>>>>>+<<]>>[-<<+>>]<<[-]>>[-]>>[-]<<<<<<<<<<<[->>>>>>>>>+
+>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<[-]++++++++++<[->->[-]+>[-]
+>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<<+>>>[-]++++++++++>[-]]<<]<<<<<<[
+-]++++++++++>>>>>>>[-<<<<<<<->>>>>>>]<<<<<<<<<<[-]>>>>>>>>>>[-]<<<[-<<<<<<<+>>>>
+>>>>>>+<<<]>>>[-<<<+>>>]<<<[-]>>>[-]>[-]<<<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>
+>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<[-]++++++++++>[-<->>[-]+>[-]>[-]<<<<[->>>+>
++<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<<+>>[-]++++++++++>>[-]]<]<<<<<<<<[-]++++++
+++++>>>>>>>[-<<<<<<<->>>>>>>]<<<<<<<<<[-]>>>>>>>>>[-]<<[-<<<<<<<+>>>>>>>>>+<<]>>
+[-<<+>>]<<[-]>>[-]>>[-]<<<<<<<<<<<[->>>>>>>>>+>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<
+<<<<<+>>>>>>>>>>>]<[-]++++++++++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[<
+[-]>[-]]<[<<<<+>>>[-]++++++++++>[-]]<<]<<<<<<<<[-]++++++++++>>>>>>>>>[-<<<<<<<<<
+->>>>>>>>>]<<<<<<<<<<[-]>>>>>>>>>>[-]<<<[-<<<<<<<+>>>>>>>>>>+<<<]>>>[-<<<+>>>][-
+]<[-]>>[-]<<<<<<<<<<[->>>>>>>>+>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<
+<[>[-]+<[-]][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<<<<<++++++++++++++++++++++++++++++++
+++++++++++++++++.------------------------------------------------>>>>>>>>[-]][-]
+>>[-]<<<<<<<<<[->>>>>>>+>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>>]<<[>[-]+<[-]
+][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<<<<++++++++++++++++++++++++++++++++++++++++++++
+++++.------------------------------------------------>>>>>>>[-]][-]>>[-]<<<<<<<<
+[->>>>>>+>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<[>[-]+<[-]][-]>>[-]<[-<+>>+<]
+>[-<+>]<<[<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++.---------------
+--------------------------------->>>>>>[-]][-]>>[-]<<<<<<<[->>>>>+>>+<<<<<<<]>>>
+>>>>[-<<<<<<<+>>>>>>>]<<[>[-]+<[-]][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<<++++++++++++
+++++++++++++++++++++++++++++++++++++.-------------------------------------------
+----->>>>>[-]]<++++++++++++++++++++++++++++++++++++++++++++++++.----------------
+--------------------------------[-]<<<<[-]<[-]<[-]<[-]<[-]>>>>>>>[-]>>>[-]<<<<<<
+<<<<<<<<[-]>>>>>>>>>>[-]]<[<<<<<<<[-]>>>>>>>>[-]>[-]<<<<<<<<<<<<<<[->>>>>>>>>>>>
+>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]>>>[-]<<<[-]<<<
+<<<<<<<<<<[->>>>>>>>>>>>>>>>+<<<+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>
+>>>>>>>>>]<[->>>>-<<<[-]+<<<<<<<[-]>[-]>>>>>>>>>[-<<<<<<<<<<+>+>>>>>>>>>]<<<<<<<
+<<[->>>>>>>>>+<<<<<<<<<]<[>>>>>>>[-]<<<<<<<[-]]>>>>>>>[<<<<<<<<<+>>>>>>>>>>>>[-]
+<<<<<<<<<<[-]<<<<<<[->>>>>>>>>>>>>>>>+<<<<<<<<<<+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]>>
+>>>>>[-]]<]<<<<<<<[-]>>>>>>>>[-]<<<<<<<<<<<<<[->>>>>+>>>>>>>>+<<<<<<<<<<<<<]>>>>
+>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>]>>>[-<<<<<<<<<<<->>>>>>>>>>>][-]+<<<<[-]>
+[-]<<<<<<<<[->>>>>>>+>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<[>>>>[-]<<<<<<<<<<<
+<<<<<+>>>>>>>>>>>>[-]]>>>>[<<<<[-]++++++++++++++++++++++++++++++++.[-]<<<[-]>>>>
+>[-]<<<<<<<<<<<<<<[->>>>>>>>>+>>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<
+<+>>>>>>>>>>>>>>]<<<<[-]>>>>[-]>>>[-]<<<<<<<<[->>>>>+>>>+<<<<<<<<]>>>>>>>>[-<<<<
+<<<<+>>>>>>>>]<<[-]++++++++++<[->->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>
+]<[<[-]>[-]]<[<<<<<<<+>>>>>[-]++++++++++>>[-]]<<<]<<[-]++++++++++>>>[-<<<->>>]<<
+<<<<[-]>>>>>>[-]<<<<<[-<+>>>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<[-]>>>>>[-]>>[-]<<
+<<<<<<[->>>>>>+>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<<[-]++++++++++>[-<->>>[
+-]+>[-]>[-]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[<[-]>[-]]<[<<<<<<<+>>>>[-]++
+++++++++>>>[-]]<<]<<[-]++++++++++>[-<->]<<<<<[-]>>>>>[-]<<<<[-<+>>>>>+<<<<]>>>>[
+-<<<<+>>>>]<<<<[-]>>>>[-]>>>[-]<<<<<<<<[->>>>>+>>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>
+>>>>>>>]<<[-]++++++++++<[->->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-
+]>[-]]<[<<<<<<<+>>>>>[-]++++++++++>>[-]]<<<]<<<<<<<<[-]++++++++++>>>>>>>>>[-<<<<
+<<<<<->>>>>>>>>]<<<<<<[-]>>>>>>[-]<<<<<[-<+>>>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<<
+[-]>>>>>[-]>>[-]<<<<<<<<[->>>>>>+>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<<[-]+
++++++++++>[-<->>>[-]+>[-]>[-]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[<[-]>[-]]<
+[<<<<<<<+>>>>[-]++++++++++>>>[-]]<<]<<<<<<<<[-]++++++++++>>>>>>>[-<<<<<<<->>>>>>
+>]<<<<<[-]>>>>>[-]<<<<[-<+>>>>>+<<<<]>>>>[-<<<<+>>>>]<<<<[-]>>>>[-]>>>[-]<<<<<<<
+<[->>>>>+>>>+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]<<[-]++++++++++<[->->>[-]+>[-]
+>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<<<<<+>>>>>[-]++++++++++>>[-
+]]<<<]<<<<<<[-]++++++++++>>>>>>>[-<<<<<<<->>>>>>>]<<<<<<[-]>>>>>>[-]<<<<<[-<+>>>
+>>>+<<<<<]>>>>>[-<<<<<+>>>>>][-]<[-]>>>[-]<<<<<<<<<[->>>>>>+>>>+<<<<<<<<<]>>>>>>
+>>>[-<<<<<<<<<+>>>>>>>>>]<<<[>[-]+<[-]][-]>>>[-]<<[-<+>>>+<<]>>[-<<+>>]<<<[<<<<<
+<++++++++++++++++++++++++++++++++++++++++++++++++.------------------------------
+------------------>>>>>>[-]][-]>>>[-]<<<<<<<<<<[->>>>>>>+>>>+<<<<<<<<<<]>>>>>>>>
+>>[-<<<<<<<<<<+>>>>>>>>>>]<<<[>[-]+<[-]][-]>>>[-]<<[-<+>>>+<<]>>[-<<+>>]<<<[<<<<
+<<<++++++++++++++++++++++++++++++++++++++++++++++++.----------------------------
+-------------------->>>>>>>[-]][-]>>>[-]<<<<<<<<<<<[->>>>>>>>+>>>+<<<<<<<<<<<]>>
+>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<<[>[-]+<[-]][-]>>>[-]<<[-<+>>>+<<]>>[-<<+>>
+]<<<[<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++.------------------
+------------------------------>>>>>>>>[-]][-]>>>[-]<<<<[->+>>>+<<<<]>>>>[-<<<<+>
+>>>]<<<[>[-]+<[-]][-]>>>[-]<<[-<+>>>+<<]>>[-<<+>>]<<<[<+++++++++++++++++++++++++
++++++++++++++++++++++++.------------------------------------------------>[-]]<<+
++++++++++++++++++++++++++++++++++++++++++++++++.--------------------------------
+----------------[-]>[-]<<<<<<<[-]>[-]>[-]>[-]>[-]>>>>>[-]<<<<<<<<<<<<<<<<[-]>>>>
+>>>>>>>>>>>>[-]<<<<<<<<<<<[-<<<<<+>>>>>>>>>>>>>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<
+<<<<<<<+>>>>>>>>>>>]>[-]]<<<<<<<<<<<<[-]>[-]>>>>>>[-]]<<<<<<<<[-]<<[-]>]>>>>>>>>
+>[-]++++++++++.[-]<<<<<<<<<<<<[-]>[-]<<<]
@@ -0,0 +1,54 @@
+( Towers of Hanoi
+  Prints the 1023 moves that solve the puzzle for 10 disks, one per line.
+  Move m takes a disk from peg (m and (m - 1)) mod 3 to peg
+  ((m or (m - 1)) + 1) mod 3, the bitwise operations being done one bit
+  at a time by halving.
+  Needs 16-bit cells )
+
+[-]+>>>>>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>
+>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<
+<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<
+<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]
+>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>
+>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]
+[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>
+>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>
+>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<
+<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>++<<<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<<<->[-
+]<[->+>[-]>>>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<[->+>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<<<<<<<<<<<<<<->[-]>>>>>>>>>>>>>[-
+]<<<<<<<<<<<<<<<[->>+>>>>>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<
+<<<+>>>>>>>>>>>>>>>]<<<<<<<<<<<<[-]>>>>>>>>>>>>[-]<<<<<<<<<<<<<<[->>+>>>>>>>>>>>
+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<<<<<<<[-]+>[
+-]>[-]>[-]++++++++++[->[-]>>>>>>>[-]>>[-]<<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>>+<<<<<
+<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<[-]++<[->->[-]+>[-]
+>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<<<<<<<+>>>>>>>>[-]++>[-]]<<]<<<<<
+<[-]++>>>>>>>[-<<<<<<<->>>>>>>]<<<<<<[-]>>>>>>[-]>[-]<<<<<<<<<<<<<<[->>>>>>>>>>>
+>>+>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<[-]++>[-<->>
+[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<<<<<+>>>>>[-]++>>[-
+]]<]<<<<<[-]++>>>>[-<<<<->>>>]<<<[-]>>>[-]>[-]<<<<<<<[->>>>>>+>+<<<<<<<]>>>>>>>[
+-<<<<<<<+>>>>>>>]<[>[-]>[-]<<<<<<[->>>>>+>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]<[<<<<[-
+]+>>>>[-]]<[-]][-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]<<<<<<<<<<<<[->+>>>
+>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<[-]]<<<[-]>>>[-]<
+<<<<<[->>>+>>>+<<<<<<]>>>>>>[-<<<<<<+>>>>>>][-]<<<<[->+>>>+<<<<]>>>>[-<<<<+>>>>]
+[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]<<<<<<<<<<<<[->>+>>>>>>>>>>+<<<<<<
+<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<[-]]<<<[-]<<<[-]>>[-]<<<<<<<<<[-
+]>>>>>>>>>>>>>[-]<<<<<<<[-<<<<<<+>>>>>>>>>>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]
+<<<<<<<<<<<<[-]>>>>>>>>>>>>[-]<<<<<[-<<<<<<<+>>>>>>>>>>>>+<<<<<]>>>>>[-<<<<<+>>>
+>>][-]<<<<<<<<<<<[->>>>>>>>>>>++<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>
+]<<<<<<<<]>>>>>>[-]>>[-]>>[-]<<<<<<<<<<<<[->>>>>>>>>>+>>+<<<<<<<<<<<<]>>>>>>>>>>
+>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<[-]+++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>
+>]<[<[-]>[-]]<[<<<<+>>>[-]+++>[-]]<<]<[-]+++>>[-<<->>]<<++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++.--------------------------------------
+--------------------------->>[-]++++++++++++++++++++++++++++++++.+++++++++++++.+
+++++++++++++++++.------------------------------.[-]<<<<<<<<<<+>>>>>>>[-]>>>[-]>[
+-]<<<<<<<<<<<[->>>>>>>>>>+>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>]<<[
+-]+++>[-<->>[-]+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<<+>>[-]
++++>>[-]]<]<<[-]+++>[-<->]<+++++++++++++++++++++++++++++++++++++++++++++++++++++
+++++++++++++.----------------------------------------------------------------->[
+-]++++++++++.[-]<<<<<<<<<<<<<[-]>[-]>>[-]>[-]>>>>>>>[-]>[-]<<<<<<[-]>>[-]<<<<<<[
+-]<<<<<]
@@ -0,0 +1,29 @@
+( Long output stress test
+  Prints 65536 lines, each holding the 63 characters from '0' to 'n',
+  for 4 MiB of output in all
+
+  cell 0: newline
+  cell 2: first character of the line
+  cells 3 to 5: counters for 16 blocks of 64 times 64 lines
+  cell 6: characters left on the line
+  cell 7: temporary )
+
+++++++++++                          # newline
+>++++++[>++++++++<-]                # first character
+>>++++++++++++++++                  # blocks
+[
+    >>>>++++++++[<<<++++++++>>>-]<<<
+    [
+        >>>++++++++[<<++++++++>>-]<<
+        [
+            >>+++++++[<+++++++++>-]<
+            [<<<<.+>>>>-]           # print the line
+            >+++++++[<+++++++++>-]<
+            [<<<<->>>>-]            # and go back to its first character
+            <<<<<<.>>>>>
+            -
+        ]
+        <-
+    ]
+    <-
+]
@@ -0,0 +1,267 @@
+( Mandelbrot set
+  Draws the set as 17 rows of 40 characters, from -2 to 0.5 on the real
+  axis and from 1 to -1 on the imaginary one, iterating up to 12 times.
+  Numbers are fixed point with 4 fractional bits, held as a sign cell
+  and a magnitude cell, and multiplied by repeated addition.
+  Needs 16-bit cells )
+
+>>>>[-]>[-]++++++++++++++++<<<<<[-]+++++++++++++++++[->>[-]+>[-]++++++++++++++++
+++++++++++++++++<<[-]++++++++++++++++++++++++++++++++++++++++[->>>>>[-]>[-]>[-]>
+[-]>>>>>>>>>>>>>[-]<<[-]++++++++++++>[-]+[>>>>[-]>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<[
+->>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<
+<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<[->[-]<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>
+>+>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>
+>>>>>>>>>>>>>>]<]<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>[-]>>[-]<<<<[->>+>>+<<<<]>>>
+>[-<<<<+>>>>]<[-]++++++++++++++++<[->->[-]+>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<[
+<[-]>[-]]<[<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>[-]++++++++++++++++>[-]]<<]<[-]++
+++++++++++++++>>[-<<->>]<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<
+<<<<<<[->>>>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<
+<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>
+>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>>>>>>>>]>[-]<[-]>>[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>>
++<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>
+>>>>>>>>>>>>>>>>>]<<[>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>+
+>+<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>>>>>>>>>>]<[<[-]+>[-]]<<[-]][-]>>[-]<[-<+>>+<]>[-<+>]<<[<<<<<<<<<<<
+<<<<<<[-]>>>>>>>>>>>>>>>>>[-]]>[-]<<<[-]>[-][-]>>[-]<[-]<<<<<<<<<<<<<<<<<<[->>>>
+>>>>>>>>>>>>>>>+<+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>>>>>]>[-<[-]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<
+]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]>]<<<<<<<<<<<<<<<[-]>
+>>>>>>>>>>>>>>[-]>[-]<<<[->>+>+<<<]>>>[-<<<+>>>]<<[-]++++++++++++++++>[-<->>[-]+
+>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<[-]>[-]]<[<<<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>[-]++++++++++++++++>>[-]]<]<<<[-]++++++++++++++++>>[-<<->>]<<<<<<<<<<<<<<<[
+-]>>>>>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<
+<<<<<]>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<
+<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<[-]>[-]>[-]<<<<<<<<<<<<<<<<<<<<<[->>>
+>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<
+<<<<<<+>>>>>>>>>>>>>>>>>>>>>]<[>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>
+>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>
+>>>>>>>>>>>>>>>>>>>]<[<<[-]+>>[-]]<[-]][-]>[-]<<[->+>+<<]>>[-<<+>>]<[<<<<<<<<<<<
+<<<<<[-]>>>>>>>>>>>>>>>>[-]]<[-]<[-]<[-]<[-]>[-]<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>+
+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>][-]<<<<<<<<<<<<[->>
+>>>>>>>>>+>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>][-]++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++>[-]>>>[-]<<<<<[->>+>>>+<<<<
+<]>>>>>[-<<<<<+>>>>>]<<[-]>>[-]<<<<[->>+>>+<<<<]>>>>[-<<<<+>>>>]<[-]>[-]>[-]<<<<
+[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+
+>>[-]]<[-]]<[<<->->[-]>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[-]<<<<[->
+>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[-]]<[-]]<]<<<<<[-]>>>>>>[-]>[-]<<<<[->>>+>+
+<<<<]>>>>[-<<<<+>>>>]<[<<<<<<[-]+>>>>>>[-]]<<<[-]>[-]<<[-]<[-]>[-]+>>>[-]<[-]<<<
+<[->>>>>+<+<<<<]>>>>[-<<<<+>>>>]>[<<<[-]<<<[-]+<[-]>>>>>>>[-]]<<<[>>>[-]<<[-]>>>
+[-]<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>+>>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>]<<<[->>>[-]<<<<<<<<<<<<<<<<<
+<<<<<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<
+<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<<<]<<<<<<<<<<<[-]>>>>>>>>>>>[-]>>>>
+[-]<<[-<<+>>>>+<<]>>[-<<+>>]<[-]++++++++++++++++<<<[->>>->[-]+>[-]>[-]<<<[->>+>+
+<<<]>>>[-<<<+>>>]<[<[-]>[-]]<[<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>[-]++++++++++++++++>
+[-]]<<<<]>[-]++++++++++++++++>>[-<<->>]<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>[-]<<<<<<<<
+<<<<<<<<<<<<[->>>>>>>>+>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<[->>>>>>+>>>>>>>>>
+>>>+<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>
+]>>>[-]<<<[-]>>>>[-]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>+>>>>+<<<<<<<<
+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>
+>>>>>>>>>>>>]<<<<[>>>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>+>+<
+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>
+>>>>>>>>>>>>>>>]<[<[-]+>[-]]<<<<[-]][-]>>>>[-]<[-<<<+>>>>+<]>[-<+>]<<<<[<<<<<<<<
+<<<<[-]>>>>>>>>>>>>[-]]>>>[-]<[-]<[-]<<<<<<<<<<[-]>>>>>>>>>>[-]<<<<<<<<<<<<[->>+
+>>>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>][-]<<<<<<<<<<<<[
+->>+>>>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<<<<<<<[
+-]>>>>>>>>>>>[-]<<<<<<<<<<<<<[->>+>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<
+<<<<<<<<+>>>>>>>>>>>>>][-]<[-]<<<<<<<<<<[->>>>>>>>>>>+<+<<<<<<<<<<]>>>>>>>>>>[-<
+<<<<<<<<<+>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>+<+<<<<<<
+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>
+>>>>>>]>>>[-]<<<[-]>>>>[-]<<<<<<<<<<<<<<[->>>>>>>>>>+>>>>+<<<<<<<<<<<<<<]>>>>>>>
+>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<[>>>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<<<<
+<<[->>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>
+>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[<[-]+>[-]]<<
+<<[-]][-]>>>>[-]<[-<<<+>>>>+<]>[-<+>]<<<<[>[-]<[-]]>>>[-]<<<<<<<<<<<<<<<<<<<<[-]
+<[-]>>>>>>>>>>>>>>>>>>>>>[-]+<<<[-]>>>>[-]<<<[-<+>>>>+<<<]>>>[-<<<+>>>]<<<<[>>>[
+-]>[-]>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>+>>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<[-]>>[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>
+>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]>[-]>[-]<<<<
+[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+
+>>[-]]<[-]]<[<<->->[-]>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[-]<<<<[->
+>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[-]]<[-]]<]<<<<[-]>>>>>[-]>[-]<<<<[->>>+>+<<
+<<]>>>>[-<<<<+>>>>]<[<<<<<[-]+>>>>>[-]]<<<[-]>[-]>[-]+<[-]<[-]<<[->>>+<+<<]>>[-<
+<+>>]>[>[-]<<[-]<<<<<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>
+>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>->>>>>>
+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<
+<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>
+>>>>>>>>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]>[-]]>[
+<[-]<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<
+<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>
+>>>>>>>>][-]<<<<<<<<<<<<<<[-<<<<<<<<->>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<]>>>>>
+>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>+>>
+>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>]>[-]]<<<<[-]<<[-]]>>>[<<<
+[-]<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>>>>>>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>>
+>][-]<<<<<<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>
+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<[-<<<<<
+<<<+>>>>>>>>>>>>>>>>>>+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]>>>[-]]<<[-]
+<<<<<<<<<<<[-]+>[-]>>>>>>>>>>>[-]<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>+<<<<<<<<<<<<<
+<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>][-]<<[-]<<<<<<<<<<<<<<<<[->>
+>>>>>>>>>>>>>>>>+<<+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>
+>>>>>>>>][-]<<<<<<<<<<[->>>>>>>>>>>>+<<+<<<<<<<<<<]>>>>>>>>>>[-<<<<<<<<<<+>>>>>>
+>>>>]>>>[-]<<<[-]>>>>>>[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>+>>>>>>+<<<<<<
+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>
+>>>>>>]<<<<<<[>>>>>>[-]<[-]<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>+<+<<<<<<<<<<<<<<<]>
+>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]>[<<<[-]+>>>[-]]<<<<<<[-]][-]>>>
+>>>[-]<<<[-<<<+>>>>>>+<<<]>>>[-<<<+>>>]<<<<<<[>>[-]<<[-]]>>>[-]<<<<<<<<<<<<<<[-]
+<[-]>>>>>>>>>>>>>>>[-]+<<<[-]>>>>>>[-]<<<<[-<<+>>>>>>+<<<<]>>>>[-<<<<+>>>>]<<<<<
+<[>>>[-]>>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<
+<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<
+<[-]>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-
+<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<[-]>>>[-]>[-]<<[->+>+<<]>>[-<<+>>]<[>[-]>[-
+]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<<<[-]+>>>>[-]]<[-]]<<<[>>-<-<[-]>>>[-]>[-]
+<<[->+>+<<]>>[-<<+>>]<[>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<<<[-]+>>>>[-
+]]<[-]]<<<]<<<[-]>>>>>>[-]>[-]<<[->+>+<<]>>[-<<+>>]<[<<<<<<[-]+>>>>>>[-]]<[-]<[-
+]<[-]+>[-]>[-]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[<[-]>>[-]<<<<<<<<<<<<<<<<
+<<<<<[->>>>+>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>[-<<<<<
+<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<[-<<->>>>>>>>>>>>>>>>>+
+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<
+<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>
+>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]<[-]]<[>[-]<<<<<<<<<<<<<<[-<<+>
+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>][-]
+<<<<<<<<<<<<<<<<<<<<[->>>>->>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>
+>>>>>[-<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<[-<<+>>>>>>>>
+>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<[-]]
+<<<[-]<[-]]>>>[<<<[-]<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>
+>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>][-]<<<<<<<<<[-<<+>>>>>>>>>>>+<<<<<<<<<]>
+>>>>>>>>[-<<<<<<<<<+>>>>>>>>>][-]<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>+<<<<<<<<<<<
+<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]>>>[-]]<[-]<[-]<[-]<<<
+<<<<<<<<<[->>>>>>>>>>>>>+<+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]
+[-]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>+<+<<<<<<<<<<<<<<<<<<<<<<<
+<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>]>>
+>[-]<<<[-]>>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+>>>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>
+>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<[>>>>[-]>[-]<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>+>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+]<[<[-]+>[-]]<<<<[-]][-]>>>>[-]<[-<<<+>>>>+<]>[-<+>]<<<<[>[-]<[-]]>>>[-]<<<<<<<<
+<<<<<<<<<<<<<<[-]<[-]>>>>>>>>>>>>>>>>>>>>>>>[-]+<<<[-]>>>>[-]<<<[-<+>>>>+<<<]>>>
+[-<<<+>>>]<<<<[>>>[-]>[-]>>>[-]<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>+>>>+<<<<<<<<<
+<<<<<<<<<]>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>]<<[-]>>[-]<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>>>>>>>>>>>>>>>+>>+<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>]<[-]>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[
+-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[-]]<[-]]<[<<->->[-]>[-]>[-]<<<<[->
+>>+>+<<<<]>>>>[-<<<<+>>>>]<[>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[
+-]]<[-]]<]<<<<[-]>>>>>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<<<<[-]+>>>>>[-
+]]<<<[-]>[-]>[-]+<[-]<[-]<<[->>>+<+<<]>>[-<<+>>]>[>[-]<<[-]<<<<<<<<<<<<<<<[-<<<<
+<<<<+>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>
+>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>->>>>>>>>>>>>>>>>>>>>>>>+<<<<<
+<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<+
+>>>>>>>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>
+>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]>[-]]>[<
+[-]<<<<<<<<<<<<<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[-<<<<<<<<->>>>>>>>>>>>>>>>>>>>>>>>+<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<[->>>>+>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<]>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>]>[-]]<<<<[-]<<[-]]>>>[<<<[-]<<<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>>>>>>>>>+
+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<<<<<<<<[->>>
+>+>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<
+<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<[-<<<<<<<<+>>>>>>>>>>>>>>>
+>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>>>[-]]<<[-]<<<<<<<->
+>>>>>>>[-]+<[-]>>[-]<<<<<<<<<[->>>>>>>+>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<<<<+>>>>>>>
+>>]<<[>[-]<[-]]>[<<<<<<<[-]>>>>>>>[-]]<<<[-]]<<[-]<<]>>>>[-]+>>>[-]<[-]<<<<<[->>
+>>>>+<+<<<<<]>>>>>[-<<<<<+>>>>>]>[<<<[-]<<<<<<[-]++++++++++++>>>>>>>>[-]<<<<<<<[
+-<->>>>>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>][-]+++++++>>[-]>>[-]<<<<<<<<<<<<[->
+>>>>>>>>>+>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<<[-]>>>>>[
+-]<<<<[-<+>>>>>+<<<<]>>>>[-<<<<+>>>>]>[-]<[-]<[-]<[->>+<+<]>[-<+>]>[<[-]>>>[-]<<
+<<<<<[->>>>+>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<[>>[-]+<<[-]]>[-]]>[<<<-<<<-
+>>>>>>[-]<[-]<[-]<[->>+<+<]>[-<+>]>[<[-]>>>[-]<<<<<<<[->>>>+>>>+<<<<<<<]>>>>>>>[
+-<<<<<<<+>>>>>>>]<<<[>>[-]+<<[-]]>[-]]>]<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>[-]<[-]<[-
+>>+<+<]>[-<+>]>[<<<<<<<<<<<<<[-]+>>>>>>>>>>>>>[-]]<<[-]<<<[-]>[-][-]+>>>>>[-]<<<
+<<<[-]<<<<<<<<[->>>>>>>>>>>>>>+<<<<<<+<<<<<<<<]>>>>>>>>[-<<<<<<<<+>>>>>>>>]>>>>>
+>[<<<<<[-]<[-]+++++++++++++++++++++++++++++++++++++++++++.[-]>>>>>>[-]]<<<<<[>>>
+>>[-]++++<<<<<<[-]>>>>[-]<<<<<<<<<<<[->>>>>>>+>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<
+<<<<<<<+>>>>>>>>>>>]<[-]>[-]>>[-<<<+>+>>]<<[->>+<<]>[-]<[-]>>>[-]<<<<<<<[->>>>+>
+>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<[>>>[-]>[-]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<
+<<+>>>>>]<[<<[-]+>>[-]]<<<[-]]>[<<<<<->>>->>[-]<[-]>>>[-]<<<<<<<[->>>>+>>>+<<<<<
+<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<[>>>[-]>[-]<<<<<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>
+]<[<<[-]+>>[-]]<<<[-]]>]<<<<<<<<[-]>>>>>>>[-]>>>[-]<<<<<<<[->>>>+>>>+<<<<<<<]>>>
+>>>>[-<<<<<<<+>>>>>>>]<<<[<<<<<<<[-]+>>>>>>>[-]]<<<<[-]>>>[-]>>>[-][-]+<[-]<<[-]
+<<<<<<[->>>>>>>>+<<+<<<<<<]>>>>>>[-<<<<<<+>>>>>>]>>[>[-]<<<[-]++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++.[-]>>[-]]>[<[-]++<<[-]>>>>[-]<<<<<<<<<<
+<<<<[->>>>>>>>>>+>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>
+>>]<<<<<<<[-]>>>>>>>[-]<<[-<<<<<+>>>>>>>+<<]>>[-<<+>>]<<<[-]>>>[-]>[-]<<<<<[->>>
+>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[>[-]>[-]<<<<<<<<<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>>>
+[-<<<<<<<<<+>>>>>>>>>]<[<<<<[-]+>>>>[-]]<[-]]<<<[<-<<<->>>>[-]>>>[-]>[-]<<<<<[->
+>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[>[-]>[-]<<<<<<<<<[->>>>>>>>+>+<<<<<<<<<]>>>>>>>
+>>[-<<<<<<<<<+>>>>>>>>>]<[<<<<[-]+>>>>[-]]<[-]]<<<]<<<<<<[-]>>>>>>>>>[-]>[-]<<<<
+<[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<[<<<<<<<<<[-]+>>>>>>>>>[-]]<<<<[-]<<<[-]>>>>
+>[-][-]+<[-]<<<<[-]<<[->>>>>>+<<<<+<<]>>[-<<+>>]>>>>[>[-]<<<<<[-]+++++++++++++++
++++++++++++++++++++++++++++++++.[-]>>>>[-]]>[<[-]+++++++++++++++++++++++++++++++
++.[-]>[-]]<<<<<<<[-]>>>>>>>>[-]]<<<<<<<<<[-]>>>>[-]]<<<<<<<<<[-]>[-]>>>>>>>>>[-]
+]<<<[>>>[-]+++++++++++++++++++++++++++++++++++.[-]<<<[-]]<<<<<<<[-]>[-]+<<<[-]>>
+>>>>>>>[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>+>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<
+<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>]<<<
+<<<<<[-]>>>>>>>>[-]<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>>>+>>>>>>>>+<<<<<<<<<<<<<
+<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>]
+[-]>>>>>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>+>>>>>>>+<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>
+>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<[->>>>>>>+>>>>>>>+<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]<<<<<[-]>>>>>[-]<[-]<<<<<<
+<<<<<<<<<[->>>>>>>>>>>>>>>>+<+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>
+>>>>>>>>>>>>>>]>[<[-]<[-]<<<<<<<<<<<<[->>>>>>>>>>>>>+<+<<<<<<<<<<<<]>>>>>>>>>>>>
+[-<<<<<<<<<<<<+>>>>>>>>>>>>]>[<<<<[-]+>>>>[-]]>[-]][-]<[-]<<<<[->>>>>+<+<<<<]>>>
+>[-<<<<+>>>>]>[<<<<<<<[-]>>>>>>>[-]]<<<<<[-]<<<<<<<<<<<<<<<<<<<<<<<<[-]<[-]>>>>>
+>>>>>>>>>>>>>>>>>>>>[-]+>>>>>[-]<[-]<<<<<<[->>>>>>>+<+<<<<<<]>>>>>>[-<<<<<<+>>>>
+>>]>[<<<<<[-]>>>>[-]<<[-]<<<<<<<<<<<<[->>>>>>>>>>>>>>+<<+<<<<<<<<<<<<]>>>>>>>>>>
+>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>[-]<[-]<<<<<<<<<<[->>>>>>>>>>>+<+<<<<<<<<<<]>>>>>
+>>>>>[-<<<<<<<<<<+>>>>>>>>>>]<<<[-]>>>[-]>>>>[-]<<[-<<+>>>>+<<]>>[-<<+>>]<<<<[>>
+>>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<<<<<<[-]+>>>>>>>[-]]<<<<[-]]<<<[>>
+>>>-<-<<<<[-]>>>[-]>>>>[-]<<[-<<+>>>>+<<]>>[-<<+>>]<<<<[>>>>[-]>[-]<<<<[->>>+>+<
+<<<]>>>>[-<<<<+>>>>]<[<<<<<<<[-]+>>>>>>>[-]]<<<<[-]]<<<]>>[-]>[-]>>>>[-]<<[-<<+>
+>>>+<<]>>[-<<+>>]<<<<[<[-]+>[-]]>>[-]<[-]<<<<[-]+>>>>[-]>[-]<<<[->>+>+<<<]>>>[-<
+<<+>>>]<[<<<<[-]>>>>>[-]<<<<<<<<<<<<<<[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>][-]<<<<<<<<<<<<
+[-<<<<<<<<<<<<<<<<->>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<
+<<<<<<<+>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>]<[-]]<<<<
+[>>>>[-]<<<<<<<<<<<[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<]>>
+>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>][-]<<<<<<<<<<<<<[-<<<<<<<<<<<<<<->>>>>>>>>>>>
+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>][-]<<<<
+<<<<<<<<[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<]>>>>>>>>>>>
+>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<[-]]>>[-]>>>>[-]]<<<<<[>>>>>[-]<<<<<<<<<<<<<<<[
+-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>[-<
+<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<+>>>>>>>>>>>>>][-]<<<<
+<<<<<<<<<<<<[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<<<<]>>>
+>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<<[-]]<<[-]<<<<<<<[-]>[-]<<<
+<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>[-]++++++++++.[-]<<<<<<<<<<[-]+>[-]++
+<<<[-]>>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+>>>>>>>>>>>>+<<<<<<<
+<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<<<<<<+>>>>>>>>>>>
+>>>>>>>>>>>>>]<<<<<<<<<<<[-]>>>>>>>>>>>[-]<<<<<<<<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+
+>>>>>>>>>>>+<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<<<<
+<<<<+>>>>>>>>>>>>>>>>>>>>>>>][-]>>>>[-]<<<<<<<<<<<<<<<<[->>>>>>>>>>>>+>>>>+<<<<<
+<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<
+<[->>>>>>>>>>+>>>>+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>]
+<<<<<[-]>>>>>[-]<<<<<<[-]<<<<<<<<<<[->>>>>>>>>>>>>>>>+<<<<<<+<<<<<<<<<<]>>>>>>>>
+>>[-<<<<<<<<<<+>>>>>>>>>>]>>>>>>[<<<<<<[-]>>>>[-]<<<<<<<<<<<<[->>>>>>>>+>>>>+<<<
+<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]<<<<[>[-]+<[-]]>>>>>>[-]][-]<<
+<<<<[-]>[->>>>>+<<<<<<+>]<[->+<]>>>>>>[<<<<[-]>>>>[-]]<<<<<[-]<<<<<<<<<<<<<<<<<<
+<<<<[-]<[-]>>>>>>>>>>>>>>>>>>>>>>>[-]+>>>>>[-]<<<<<<[-]>>[->>>>+<<<<<<+>>]<<[->>
++<<]>>>>>>[<<<<<[-]<[-]>>>[-]<<<<<<<<<<<<[->>>>>>>>>+>>>+<<<<<<<<<<<<]>>>>>>>>>>
+>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>[-]<[-]<<<<<<<<<<[->>>>>>>>>>>+<+<<<<<<<<<<]>>>>>
+>>>>>[-<<<<<<<<<<+>>>>>>>>>>]>>[-]<<[-]>>>>[-]<<<<<<<[->>>+>>>>+<<<<<<<]>>>>>>>[
+-<<<<<<<+>>>>>>>]<<<<[>>>>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[-]]
+<<<<[-]]>>[<<<<<->>>>->[-]<<[-]>>>>[-]<<<<<<<[->>>+>>>>+<<<<<<<]>>>>>>>[-<<<<<<<
++>>>>>>>]<<<<[>>>>[-]>[-]<<<<[->>>+>+<<<<]>>>>[-<<<<+>>>>]<[<<[-]+>>[-]]<<<<[-]]
+>>]<<<<<<[-]>>>>[-]>>>>[-]<<<<<<<[->>>+>>>>+<<<<<<<]>>>>>>>[-<<<<<<<+>>>>>>>]<<<
+<[<<<<[-]+>>>>[-]]<<<[-]>>>>[-]>[-]+<[-]<<<<[-]<[->>>>>+<<<<+<]>[-<+>]>>>>[>[-]<
+<<<<[-]<<<<<<<<<[-<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<]>>>>>>>>>[-<<<<<<
+<<<+>>>>>>>>>][-]<<<<<<<[-<<<<<<<<<<<<<<->>>>>>>>>>>>>>>>>>>>>+<<<<<<<]>>>>>>>[-
+<<<<<<<+>>>>>>>][-]<<<<<<<<<<[-<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<]>>
+>>>>>>>>[-<<<<<<<<<<+>>>>>>>>>>]>>>>[-]]>[<[-]<<<<<<<<<<<[-<<<<<<<<<<<<<<+>>>>>>
+>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<]>>>>>>>>>>>[-<<<<<<<<<<<+>>>>>>>>>>>][-]<<<<<<<<
+<<<<<[-<<<<<<<<<<<<->>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<
+<<<<<<<<+>>>>>>>>>>>>>][-]<<<<<<<<<<<<[-<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>
+>+<<<<<<<<<<<<]>>>>>>>>>>>>[-<<<<<<<<<<<<+>>>>>>>>>>>>]>[-]]<<<<<<[-]>>>>>>>[-]]
+<<<<<[>>>>>[-]<<<<<<<<<<<<<<<[-<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<
+<<<<<<<]>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>][-]<<<<<<<<<<<<<[-<<<<<
+<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<<<<<<<<<<<<]>>>>>>>>>>>>>[-<<<<<<<<<<<<<
++>>>>>>>>>>>>>][-]<<<<<<<<<<<<<<<<[-<<<<<<<<<<<<+>>>>>>>>>>>>>>>>>>>>>>>>>>>>+<<
+<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>[-<<<<<<<<<<<<<<<<+>>>>>>>>>>>>>>>>]<<<<<[-]]>[-]
+<<<<<<<<<<[-]>[-]<<<<<<<<<<<<<<<<<<<]
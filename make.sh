@@ -1,3 +1,12 @@
+gcc -Wall -Wextra -Os -s -pthread src/*.c -o brainduck
+gcc -Wall -Wextra -Os -s -pthread -fPIC -shared -fvisibility=hidden -DBRAINDUCK_LIBRARY src/*.c -o libbrainduck.so
 
-gcc -Wall -Wextra -Os -s src/brainduck.c -o brainduck
+# 'sh make.sh bench' also runs the benchmarks, printing one JSON object per script and engine
+if [ "$1" = "bench" ]; then
+    gcc -Wall -Wextra -O2 bench/bench.c -o bench/bench && bench/bench ./brainduck bench/corpus.txt
+fi
 
+# 'sh make.sh test' also runs the regression tests
+if [ "$1" = "test" ]; then
+    sh tests/run.sh ./brainduck
+fi
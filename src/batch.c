@@ -0,0 +1,231 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+/*
+Batch mode: runs every job listed in a manifest on a pool of worker threads.
+Each line of the manifest holds a script, the file its input is read from
+and the file its output is written to, separated by whitespace. An input
+of '-' means no input at all. Blank lines and lines starting with '#'
+are skipped.
+
+Every job runs in its own context, with its own stack and I/O buffers.
+Jobs are dealt out to the workers up front. Each worker takes its next
+job from the back of its own queue, and once that is empty it steals
+from the front of another worker's queue, so a worker held up by a long
+job does not hold back the short jobs queued behind it.
+*/
+
+#define MANIFEST_LINE 4096 // longest manifest line
+
+typedef struct job {
+    char* script;
+    char* input;
+    char* output;
+    Error result;
+} Job;
+
+/* Queue of job indices owned by one worker */
+typedef struct worker {
+    pthread_t thread;
+    int started; // running on a thread of its own
+    pthread_mutex_t lock;
+    size_t* queue;
+    size_t head, tail; // jobs left are queue[head] to queue[tail - 1]
+} Worker;
+
+typedef struct pool {
+    Job* jobs;
+    Worker* workers;
+    int count; // number of workers
+    const Options* opts;
+} Pool;
+
+/* Runs a job in a fresh context on the calling thread */
+static Error run_job(const Job* job, const Options* opts){
+    Error err = ERR_UNKNOWN;
+    int in = open(strcmp(job->input, "-") == 0 ? "/dev/null" : job->input, O_RDONLY);
+    FILE* out = fopen(job->output, "wb");
+    Context* context = NULL;
+
+    if (in < 0 || !out) err = ERR_FILE;
+    else if ((context = create_context(read_fd, (void*)(long)in, write_file, out))){
+        err = readfile(job->script, opts);
+        flush_output();
+        destroy_context(context);
+    }
+    if (out) fclose(out);
+    if (in >= 0) close(in);
+    return err;
+}
+
+/* Takes a job from the back of a worker's own queue, or from the front of another's */
+static int next_job(Pool* pool, int self, size_t* job){
+    int i;
+    for(i = 0; i < pool->count; ++i){
+        Worker* w = &pool->workers[(self + i) % pool->count];
+        int found = 0;
+        pthread_mutex_lock(&w->lock);
+        if (w->head < w->tail){
+            *job = (i == 0) ? w->queue[--w->tail] : w->queue[w->head++];
+            found = 1;
+        }
+        pthread_mutex_unlock(&w->lock);
+        if (found) return 1;
+    }
+    return 0;
+}
+
+typedef struct worker_arg {
+    Pool* pool;
+    int self;
+} WorkerArg;
+
+static void* worker_main(void* arg){
+    WorkerArg* wa = arg;
+    size_t job;
+    while(next_job(wa->pool, wa->self, &job)){
+        Job* j = &wa->pool->jobs[job];
+        j->result = run_job(j, wa->pool->opts);
+    }
+    return NULL;
+}
+
+/* Reads the jobs of a manifest. Returns the number of jobs, or -1 */
+static long read_manifest(const char* manifest, Job** jobs){
+    char line[MANIFEST_LINE];
+    char script[MANIFEST_LINE], input[MANIFEST_LINE], output[MANIFEST_LINE];
+    size_t count = 0, cap = 0;
+    long number = 0;
+    int invalid = 0; // stopped before the end, which may also have been reached
+    FILE* file = fopen(manifest, "r");
+
+    *jobs = NULL;
+    if (!file){
+        printf("Error: Unable to open file '%s'\n", manifest);
+        return -1;
+    }
+    while(fgets(line, sizeof(line), file)){
+        char* p = line + strspn(line, " \t\r\n");
+        number++;
+        if (*p == '\0' || *p == '#') continue;
+        if (sscanf(p, "%s %s %s", script, input, output) != 3){
+            printf("Error: invalid job on line %ld of '%s'\n", number, manifest);
+            invalid = 1;
+            break;
+        }
+        if (count == cap){
+            Job* grown = realloc(*jobs, (cap = 2 * cap + 16) * sizeof(Job));
+            if (!grown){
+                invalid = 1;
+                break;
+            }
+            *jobs = grown;
+        }
+        (*jobs)[count].script = strdup(script);
+        (*jobs)[count].input = strdup(input);
+        (*jobs)[count].output = strdup(output);
+        (*jobs)[count].result = ERR_UNKNOWN;
+        count++;
+        if (!(*jobs)[count - 1].script || !(*jobs)[count - 1].input || !(*jobs)[count - 1].output){
+            invalid = 1;
+            break;
+        }
+    }
+    if (invalid || ferror(file)){
+        while(count > 0){
+            count--;
+            free((*jobs)[count].script);
+            free((*jobs)[count].input);
+            free((*jobs)[count].output);
+        }
+        free(*jobs);
+        *jobs = NULL;
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    return (long)count;
+}
+
+/*
+Runs every job of a manifest and reports the ones that failed.
+Returns ERR_OK if all of them succeeded, or the error of the first that did not.
+*/
+int run_batch(const char* manifest, const Options* opts){
+    Job* jobs = NULL;
+    long count = read_manifest(manifest, &jobs);
+    int threads = opts->threads > 0 ? opts->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    Error result = ERR_OK;
+    Pool pool;
+    WorkerArg* args;
+    long i;
+    int w;
+
+    if (count < 0) return ERR_FILE;
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count > 0 ? (int)count : 1;
+
+    pool.jobs = jobs;
+    pool.count = threads;
+    pool.opts = opts;
+    pool.workers = calloc((size_t)threads, sizeof(Worker));
+    args = calloc((size_t)threads, sizeof(WorkerArg));
+    for(w = 0; pool.workers && w < threads; ++w){
+        pool.workers[w].queue = malloc(((size_t)count / threads + 1) * sizeof(size_t));
+        if (!pool.workers[w].queue) result = ERR_UNKNOWN;
+    }
+    if (!pool.workers || !args || result != ERR_OK){
+        for(w = 0; pool.workers && w < threads; ++w) free(pool.workers[w].queue);
+        for(i = 0; i < count; ++i){
+            free(jobs[i].script);
+            free(jobs[i].input);
+            free(jobs[i].output);
+        }
+        free(pool.workers);
+        free(args);
+        free(jobs);
+        printf("Error: unknown error\n");
+        return ERR_UNKNOWN;
+    }
+
+    /* Deal the jobs out, then run the workers, the first one on this thread */
+    for(w = 0; w < threads; ++w){
+        pthread_mutex_init(&pool.workers[w].lock, NULL);
+        args[w].pool = &pool;
+        args[w].self = w;
+    }
+    for(i = 0; i < count; ++i){
+        Worker* wk = &pool.workers[i % threads];
+        wk->queue[wk->tail++] = (size_t)i;
+    }
+    for(w = 1; w < threads; ++w){
+        // if a thread cannot be started, its jobs get stolen by the others
+        pool.workers[w].started = pthread_create(&pool.workers[w].thread, NULL, worker_main, &args[w]) == 0;
+    }
+    worker_main(&args[0]);
+    for(w = 1; w < threads; ++w){
+        if (pool.workers[w].started) pthread_join(pool.workers[w].thread, NULL);
+    }
+
+    for(i = 0; i < count; ++i){
+        if (jobs[i].result != ERR_OK){
+            printf("Error: job %ld (%s) failed with code %d\n", i + 1, jobs[i].script, jobs[i].result);
+            if (result == ERR_OK) result = jobs[i].result;
+        }
+        free(jobs[i].script);
+        free(jobs[i].input);
+        free(jobs[i].output);
+    }
+    for(w = 0; w < threads; ++w){
+        pthread_mutex_destroy(&pool.workers[w].lock);
+        free(pool.workers[w].queue);
+    }
+    free(pool.workers);
+    free(args);
+    free(jobs);
+    return result;
+}
@@ -21,29 +21,16 @@
 
     Line comments
         Line starting in a hash #
-        Brackets within must be matched
         Example:
             # line comment
 
-    -- Planned extensions --
-
-    Input numerical value
-        Similar to ',' but using semicolon ;
-        Integer value sought from stdin.
-        Hex values also supported if starting with '0x'.
-        
-    Print numerical value
-        Similar to '.' but using colon :
-        Integer value of current cell printed to stdout.
-
     Macros
-        Executes piece of code,
-        and returns instruction pointer back to caller.
+        Inlines a piece of code wherever it is called.
         Declaration starts with exclamation symbol !
         followed by macro name (only [a-z][A-Z] valid),
         and the code to execute between brackets.
             !name{code}
-        Macro call starts with the exxclamation followed
+        Macro call starts with the exclamation followed
         by the function name:
             !name
         Example:
@@ -65,7 +52,20 @@
         Called with at @ symbol followed by script name.
             @script
         Recognises scripts with .bf extension only in current directory.
-    
+
+    Input numerical value
+        Similar to ',' but using semicolon ;
+        Integer value sought from stdin.
+        Hex values also supported if starting with '0x'.
+        
+    Print numerical value
+        Similar to '.' but using colon :
+        Integer value of current cell printed to stdout.
+
+    Macros and imports are expanded before compiling, by macro.c.
+
+    -- Planned extensions --
+
     Cell References
         Allows to name cells and move the stack pointer to the specified cell.
         To name the current cell, use ampersand & followed by cell name.
@@ -88,126 +88,230 @@
 
 
 
-#include <stdio.h>
-
-#define STACK_SIZE 1000
-#define LINE_MAX 255
-
-//#define DEBUG 1
-
-typedef enum error_code {
-    ERR_OK = 0,
-    ERR_UNKNOWN_CHAR,
-    ERR_MATCHING_BRACKET,
-    ERR_BOUNDS,
-    ERR_FILE,
-    ERR_UNKNOWN
-} Error;
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
 
+#include "brainduck.h"
 
-char stack[STACK_SIZE] = {0}; // stack buffer
-char* stackptr = stack; // stack pointer
-unsigned int depth = 0; // counts how many loops the instruction pointer is enclosed in
+int output_unbuffered = 0; // write each byte as soon as it is printed
+InputMode input_mode = INPUT_LINE;
+EofMode input_eof = EOF_ZERO;
 
-/* Own implementation to avoid including string.h */
-int strcmp(const char* s1, const char* s2) {
-    while(*s1 && (*s1 == *s2)) {
-        s1++;
-        s2++;
-    }
-    return *(const unsigned char*)s1 - *(const unsigned char*)s2;
+/* Returns the value of a '--name=value' argument, or NULL if it is not that option */
+const char* option_value(const char* arg, const char* name){
+    size_t len = strlen(name);
+    if (strncmp(arg, name, len) != 0 || arg[len] != '=') return NULL;
+    return arg + len + 1;
 }
 
 void debug_stack(unsigned int max){
-    char* ptr = stack;
+    char* ptr = ctx->stack;
     unsigned int i;
+    int width = (cell_shift == 0) ? 3 : (cell_shift == 1) ? 5 : 10; // digits of the widest cell value
+    unsigned long index = (unsigned long)(ctx->stackptr - ctx->stack) >> cell_shift;
+    if (max > ctx->stack_size) max = (unsigned int)ctx->stack_size;
 
     // print stack cell numbers
-    for(i=0; i!=max; ++i) printf("%03u ", i);
+    for(i=0; i!=max; ++i) printf("%0*u ", width, i);
     printf("\n");
 
     // print stack values
-    for(i=0; i!=max; ++i) {
-        if (*ptr >= 33 && *ptr <= 126) printf("'%c' ", *(ptr++));
-        else printf("%03d ", *(ptr++));
+    for(i=0; i!=max; ++i, ptr += 1 << cell_shift) {
+        unsigned long v = get_cell(ptr);
+        if (v >= 33 && v <= 126) printf("%*s'%c' ", width - 3, "", (char)v);
+        else printf("%0*lu ", width, v);
     }
     printf("\n");
     
     // print stack pointer location
-    if( (stackptr-stack) < max) printf("%*c^", (int)(stackptr-stack)*4+2, 0);   
+    if( index < max) printf("%*c^", (int)index*(width+1) + width/2 + 1, 0);   
     printf("\n");
 }
 
-/* Retrieves line from stdin, return buffer must be freed */
-char* get_line(char* line){
-    size_t max = LINE_MAX;
-    if ( getline(&line, &max, stdin) != -1){
-        return line;
-    }
-    return NULL;
+/* Hands bytes printed to the output of the current context, and to the cache if recording */
+static void write_output(const char* data, size_t len){
+    if (len == 0) return;
+    ctx->write(ctx->out, data, len);
+    ctx->stats.bytes_out += len;
+    if (ctx->output_copy) fwrite(data, 1, len, ctx->output_copy);
 }
 
-/* COMMAND: Retrieves a single byte from stdin */
-char input_byte(){
-    char c, line[LINE_MAX];
-    if ( !(get_line(line)) ) return (char)0;
-    c = line[0];
-    return c;
+/* Writes any pending output to the output of the current context */
+void flush_output(){
+    write_output(ctx->output, ctx->output_len);
+    ctx->output_len = 0;
 }
 
-/* COMMAND: Prints a single byte to stdout */
-void print_byte(char c){
-    putc(c, stdout);
-    fflush(stdout);
+/*
+Returns the next byte of input, or EOF.
+The input buffer is refilled with a single read when it runs out,
+so this never waits for more input than is already available.
+A mapped input file is read in place, and runs out only at its end.
+*/
+int read_byte(){
+    if (ctx->input_pos == ctx->input_len){
+        long n;
+        flush_output(); // show any prompt before waiting for input
+        n = ctx->read(ctx->in, ctx->input, INPUT_SIZE);
+        if (n <= 0) return EOF;
+        ctx->input_total += (unsigned long long)n;
+        ctx->input_data = ctx->input;
+        ctx->input_len = (size_t)n;
+        ctx->input_pos = 0;
+    }
+    return (unsigned char)ctx->input_data[ctx->input_pos++];
 }
 
+/* Returns the bytes of input consumed so far, leaving out those read ahead into the buffer */
+unsigned long long input_consumed(){
+    return ctx->input_total - (ctx->input_len - ctx->input_pos);
+}
 
-/* Read one char from file without moving file pointer */
-int freadc(FILE* file){
-    int i = 0;
-    i = fgetc(file);
-    fseek(file, -1, SEEK_CUR);
-    return i;
+/* Discards the rest of a line of input, c being its last byte read */
+static void skip_line(int c){
+    while(c != '\n' && c != EOF){
+        const char* start = ctx->input_data + ctx->input_pos;
+        const char* end = memchr(start, '\n', ctx->input_len - ctx->input_pos);
+        if (end){
+            ctx->input_pos += (size_t)(end - start) + 1;
+            return;
+        }
+        ctx->input_pos = ctx->input_len;
+        c = read_byte();
+    }
 }
 
-/* Moves file pointer n bytes forward */
-int fmove(FILE* file, int n){
-    return fseek(file, n, SEEK_CUR);
+/* What a cell holding current is set to at EOF */
+static long eof_value(long current){
+    switch(input_eof){
+        case EOF_ZERO: return 0;
+        case EOF_MINUS_ONE: return -1;
+        case EOF_UNCHANGED: default: return current;
+    }
 }
 
-/* Moves file pointer n bytes backward */
-int fmoveback(FILE* file, int n){
-    if(n < 0) n = -n;
-    return fseek(file, -n, SEEK_CUR);
+/*
+COMMAND: Retrieves a single byte of input.
+In line mode, the rest of the line is discarded.
+At EOF, the cell becomes zero, -1, or keeps its current value.
+*/
+long input_byte(long current){
+    int c;
+    if (input_mode == INPUT_STREAM && ctx->input_pos < ctx->input_len) return (unsigned char)ctx->input_data[ctx->input_pos++];
+    c = read_byte();
+    if (c == EOF) return eof_value(current);
+    if (input_mode == INPUT_LINE) skip_line(c);
+    return c;
 }
 
-/* Move file pointer until either given byte or EOF is found */
-int ffindc(FILE* file, char c){
-    int ret = 0;
-    // note: simplify loop
-    while( 1 ){
-        ret = freadc(file);
-        if (ret == EOF) break;
-        else if (ret == c) break;
-        fmove(file, 1);
-    }
-    return ret;
+static int is_space(int c){
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 }
 
+/* Value of c as a digit in base 10 or 16, or -1 */
+static int digit_value(int c, int base){
+    if (c >= '0' && c <= '9') return c - '0';
+    if (base == 16 && c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (base == 16 && c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
 
-int ffindc_matching(FILE* file, char c1, char c2, int direction){
-    int depth = 0;
-    int v = 0;
-    direction = (direction < 0) ? -1 : 1;
-    while ( (v = freadc(file)) != EOF ){
-        if (v == (int)c1) depth++;
-        else if (v == (int)c2){
-            if (depth == 1) break;
-            else depth--;
+/*
+COMMAND: Reads an integer, in decimal or in hex after 0x, from the input buffer.
+Whitespace before it is skipped, and the whole token it starts is consumed,
+along with the whitespace byte that ends it. The value wraps to the cell
+width once stored. At EOF, the cell is set as by input_byte.
+*/
+long input_number(long current){
+    unsigned long value = 0;
+    int c, digit, base = 10, negative = 0;
+    do c = read_byte();
+    while (is_space(c));
+    if (c == EOF) return eof_value(current);
+    if (c == '-' || c == '+'){
+        negative = (c == '-');
+        c = read_byte();
+    }
+    if (c == '0'){
+        c = read_byte();
+        if (c == 'x' || c == 'X'){
+            base = 16;
+            c = read_byte();
         }
-        fmove(file, direction);
     }
-    return v;
+    for(; (digit = digit_value(c, base)) >= 0; c = read_byte()) value = value * (unsigned long)base + (unsigned long)digit;
+    while(c != EOF && !is_space(c)) c = read_byte(); // the rest of the token
+    return (long)(negative ? 0 - value : value);
+}
+
+/* Writes value in decimal to buf, which has room for NUMBER_SIZE bytes, and returns how many it took */
+size_t format_number(char* buf, unsigned long value){
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char digits[NUMBER_SIZE];
+    size_t n = NUMBER_SIZE;
+    // two digits at a time, from the last
+    for(; value >= 100; value /= 100) memcpy(digits + (n -= 2), pairs + 2 * (value % 100), 2);
+    if (value >= 10) memcpy(digits + (n -= 2), pairs + 2 * value, 2);
+    else digits[--n] = (char)('0' + value);
+    memcpy(buf, digits + n, NUMBER_SIZE - n);
+    return NUMBER_SIZE - n;
+}
+
+/* COMMAND: Prints the value of a cell in decimal, formatted straight into the output buffer */
+void print_number(unsigned long value){
+    char buf[NUMBER_SIZE];
+    if (OUTPUT_SIZE - ctx->output_len > NUMBER_SIZE && !output_unbuffered){
+        ctx->output_len += format_number(ctx->output + ctx->output_len, value);
+        return;
+    }
+    print_bytes(buf, format_number(buf, value));
+}
+
+/*
+COMMAND: Prints a single byte.
+Output is buffered until the buffer fills up, input is requested,
+or the script ends, unless running unbuffered.
+*/
+void print_byte(char c){
+    ctx->output[ctx->output_len++] = c;
+    if (ctx->output_len == OUTPUT_SIZE || output_unbuffered) flush_output();
+}
+
+/* Prints a run of bytes, handing any too long for the output buffer straight to the output */
+void print_bytes(const char* data, size_t len){
+    if (len <= OUTPUT_SIZE - ctx->output_len && !output_unbuffered){
+        memcpy(ctx->output + ctx->output_len, data, len);
+        ctx->output_len += len;
+        if (ctx->output_len == OUTPUT_SIZE) flush_output();
+        return;
+    }
+    flush_output();
+    write_output(data, len);
+}
+
+
+/* Prints a message after any pending output, much like printf */
+void report(const char* format, ...){
+    char message[1024];
+    va_list args;
+    int len;
+    va_start(args, format);
+    len = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (len > (int)sizeof(message) - 1) len = (int)sizeof(message) - 1;
+    if (len > 0) print_bytes(message, (size_t)len);
+    flush_output();
+}
+
+
+/* Returns the index of the first byte c at or after position i, or size if none */
+size_t findc(const char* src, size_t size, size_t i, char c){
+    while(i < size && src[i] != c) i++;
+    return i;
 }
 
 
@@ -216,188 +320,501 @@ int ffindc_matching(FILE* file, char c1, char c2, int direction){
 /*
 Loop opening.
 If value at current stack location is zero,
-skip to the next matching bracket.
+skip to the matching closing bracket.
 Otherwise, execute instructions within.
 */
-void jump_forward(FILE* file){ 
-    depth++; // watch out! this executes even when relooping;
-    if (*stackptr != (char)0) return;    
-    fmove(file, 1);
+void jump_forward(const size_t* jumps, size_t* ip){
+    if (get_cell(ctx->stackptr) == 0) *ip = jumps[*ip];
+}
 
-    char c = 0; // current character
-    unsigned int current_depth = depth;
-    
-    // note: simplify this loop
-    while( (c = freadc(file)) != EOF ){
-        if (c == '[') current_depth++; // new loop found within
-        else if (c == ']'){
-            if (current_depth == depth){
-                // matching bracket found!
-                break;
-            }
-            else{
-                // non-matching inner closing bracket
-                current_depth--;
-            }
+/*
+Loop closing.
+If value at current stack location is not zero,
+jump back to the matching opening bracket.
+Each time round, the loop takes the commands it is made of off the budget,
+if there is one, and fails with ERR_LIMIT once the run has taken too long.
+*/
+Error jump_backward(const size_t* jumps, const size_t* steps, size_t* ip){
+    if (get_cell(ctx->stackptr) != 0){
+        if (steps){
+            ctx->budget -= (long)steps[*ip];
+            if (ctx->budget <= 0 && refill_budget() != ERR_OK) return ERR_LIMIT;
         }
-        else if (c == '(') ffindc_matching(file, '(', ')', 1);
-        fmove(file, 1); // move one file position
+        *ip = jumps[*ip];
+        COUNT(iterations, 1);
     }
+    return ERR_OK;
 }
 
-
-void jump_backward(FILE* file){ 
-    if (*stackptr == (char)0){
-        depth--;
-        return;
-    }
-    
-    fmoveback(file, 1);
-
-    char c = 0; // current character
-    unsigned int current_depth = depth;
-    
-    // note: simplify this loop
-    while(1){
-        c = freadc(file);
-        if (c == ']') current_depth++; // new loop found within
-        else if (c == '['){
-            if (current_depth == depth){
-                // matching bracket found!
-                break;
-            }
-            else{
-                // non-matching inner opening bracket
-                current_depth--;
-            }
+/*
+Counts the commands of each loop of the script, its ']' included,
+which is what --max-steps charges each time round it.
+The count of a loop is stored at the index of its ']', and the index of
+each '[' is used on the way, to hold the commands before it.
+*/
+static void count_loop_steps(const char* src, size_t size, const size_t* jumps, size_t* steps){
+    size_t commands = 0, i;
+    for(i = 0; i < size; ++i){
+        switch(src[i]){
+            case '[': steps[i] = ++commands; break;
+            case ']': steps[i] = ++commands - steps[jumps[i]]; break;
+            case '(': case '#': i = jumps[i]; break;
+            case '+': case '-': case '<': case '>': case '.': case ',': case ':': case ';': commands++; break;
+            default: break;
         }
-        else if (c == ')') ffindc_matching(file, ')', '(', -1);
-        fmoveback(file, 1); // move one file position backwards
     }
-    depth--; // when forward bracket is read, depth will be incremented
-    fmoveback(file, 1); // ensure next byte read is opening bracket
 }
 
-
-
-/* Iterates through every byte of the script and executes each command */
-Error interpret_file(FILE* file){
-    char c = (char)0;
-    while((c = freadc(file)) != EOF){
-        /* Bounds checking */
-        if (stackptr < stack){
-            stackptr = stack;
-            return ERR_BOUNDS;
-        }
-        else if (stackptr >= stack + STACK_SIZE){
-            stackptr = stack + STACK_SIZE - 1;
-            return ERR_BOUNDS;
-        }
+/* Iterates through every byte of the script and executes each command, keeping the extremes of the stack pointer */
+Error interpret_file(const char* src, size_t size, const size_t* jumps){
+    size_t* steps = NULL; // commands of each loop, if its back-edges are counted
+    Error err = ERR_OK;
+    size_t ip;
+    if (budget_enabled()){
+        steps = malloc(size * sizeof(size_t));
+        if (!steps) return ERR_UNKNOWN;
+        count_loop_steps(src, size, jumps, steps);
+    }
+    touch_stack();
+    if (!ctx->reached_lo) ctx->reached_lo = ctx->reached_hi = ctx->stackptr;
+    ctx->prefix_steps = 0;
+    err = start_limits();
+    for(ip = 0; ip < size && err == ERR_OK; ++ip){
+        COUNT(steps, memchr("+-<>.,[]:;", src[ip], 10) != NULL);
         /* Read command */
-        switch(c){
-            /* instructions */
-            case '>': ++stackptr;    break;
-            case '<': --stackptr;    break;
-            case '+': ++(*stackptr); break; 
-            case '-': --(*stackptr); break;
-            case '.': print_byte(*stackptr);    break;
-            case ',': *stackptr = input_byte(); break;
-            case '[': jump_forward(file);   break;
-            case ']': jump_backward(file);  break;
+        switch(src[ip]){
+            /* instructions, with bounds checking wherever the pointer moves */
+            case '>':
+                if ((err = check_cell(1)) != ERR_OK) break;
+                ctx->stackptr += 1 << cell_shift;
+                if (ctx->stackptr > ctx->reached_hi) ctx->reached_hi = ctx->stackptr;
+                break;
+            case '<':
+                if ((err = check_cell(-1)) != ERR_OK) break;
+                ctx->stackptr -= 1 << cell_shift;
+                if (ctx->stackptr < ctx->reached_lo) ctx->reached_lo = ctx->stackptr;
+                break;
+            case '+': set_cell(ctx->stackptr, get_cell(ctx->stackptr) + 1); break; 
+            case '-': set_cell(ctx->stackptr, get_cell(ctx->stackptr) - 1); break;
+            case '.': print_byte((char)get_cell(ctx->stackptr)); break;
+            case ',': set_cell(ctx->stackptr, (unsigned long)input_byte((long)get_cell(ctx->stackptr))); break;
+            case ':': print_number(get_cell(ctx->stackptr)); break;
+            case ';': set_cell(ctx->stackptr, (unsigned long)input_number((long)get_cell(ctx->stackptr))); break;
+            case '[': jump_forward(jumps, &ip);  break;
+            case ']': err = jump_backward(jumps, steps, &ip); break;
             /* extra characters */
             case '\n': case '\0':           break; // end of line/string, ignore
-            case '(': ffindc_matching(file, '(', ')', 1); break; // comment opening
+            case '(': ip = jumps[ip]; break; // comment opening, skip to its closing bracket
             case ')': break; // comment close
-            case '#': ffindc(file, '\n');   break; // comment line, skip till next newline
+            case '#': ip = jumps[ip]; break; // comment line, skip till next newline
             case ' ': case '\r': case '\t': break; // whitespace, simply ignore
-            default: return ERR_UNKNOWN_CHAR;
+            default: err = ERR_UNKNOWN_CHAR; break;
         }
-        fmove(file, 1); // jump to next character
     }
-    return ERR_OK;
+    free(steps);
+    return err;
 }
 
-// very similar to ffindc_matching
-Error check_matching_brackets(FILE* file, char open, char close, int* where){
-    int level = 0;
-    char c = 0;
-    while((c = freadc(file)) != EOF){
-        if (c == open) level++;
-        else if (c == close) level--;
-        (*where)++;
-        fmove(file, 1);
-    }
-    fseek(file, 0, SEEK_SET); // return to start of file
-    if(level != 0) return ERR_MATCHING_BRACKET;
+/*
+Validates loop and comment brackets in a single pass over the script,
+and fills in the jump table used by the interpreter:
+the index of each loop bracket maps to its partner,
+each comment opening maps to its closing bracket,
+and each line comment maps to the newline that ends it.
+Brackets inside comments are ignored.
+If reads is not NULL, it is set to whether the script has any ',' or ';'
+outside of comments, so that the script need not be gone through again.
+On failure, 'where' is set to the offending bracket.
+*/
+Error check_matching_brackets(const char* src, size_t size, size_t* jumps, size_t* where, int* reads){
+    size_t open = size;    // innermost unmatched '[', earlier ones linked through jumps
+    size_t comment = size; // start of the outermost open comment
+    int level = 0;         // comment nesting level
+    int input = 0;
+    size_t i;
+    for(i = 0; i < size; ++i){
+        char c = src[i];
+        if (level > 0){
+            if (c == '(') level++;
+            else if (c == ')' && --level == 0) jumps[comment] = i;
+            continue;
+        }
+        switch(c){
+            case '[':
+                jumps[i] = open;
+                open = i;
+                break;
+            case ']':
+                if (open == size){
+                    *where = i;
+                    return ERR_MATCHING_BRACKET;
+                }
+                jumps[i] = open;
+                open = jumps[open];
+                jumps[jumps[i]] = i;
+                break;
+            case '(':
+                level = 1;
+                comment = i;
+                break;
+            case ')':
+                *where = i;
+                return ERR_MATCHING_BRACKET;
+            case '#':
+                jumps[i] = findc(src, size, i, '\n');
+                i = jumps[i];
+                break;
+            case ',': case ';':
+                input = 1;
+                break;
+        }
+    }
+    if (level != 0 || open != size){
+        *where = (level != 0) ? comment : open;
+        return ERR_MATCHING_BRACKET;
+    }
+    if (reads) *reads = input;
     return ERR_OK;
 }
 
+/* Finds the line and column of position pos of a script, both counted from 1 */
+static void locate(const char* src, size_t pos, int* line, int* column){
+    const char* end = src + pos;
+    const char* start = src; // of the line holding pos
+    const char* nl;
+    *line = 1;
+    while((nl = memchr(start, '\n', (size_t)(end - start))) != NULL){
+        (*line)++;
+        start = nl + 1;
+    }
+    *column = (int)(end - start) + 1;
+}
+
+/*
+Reads the whole script into a contiguous buffer, so that commands
+are executed from memory rather than through stdio.
+Returns NULL on failure. The buffer must be freed.
+*/
+char* load_file(FILE* file, size_t* size){
+    long len = 0;
+    char* buf = NULL;
+    if (fseek(file, 0, SEEK_END) != 0 || (len = ftell(file)) < 0) return NULL;
+    rewind(file);
+    buf = malloc(len > 0 ? (size_t)len : 1);
+    if (!buf) return NULL;
+    if (fread(buf, 1, (size_t)len, file) != (size_t)len){
+        free(buf);
+        return NULL;
+    }
+    *size = (size_t)len;
+    return buf;
+}
+
 Error manage_error(Error err){
     switch(err){
         case ERR_OK: break;
         case ERR_UNKNOWN_CHAR:
-            printf( "Error: unknown character\n");
+            report("Error: unknown character\n");
             break;
         case ERR_MATCHING_BRACKET:
-            printf( "Error: missing matching bracket\n");
+            report("Error: missing matching bracket\n");
             break;
         case ERR_BOUNDS:
-            printf( "Error: stack pointer out of bounds\n");
+            report("Error: stack pointer out of bounds\n");
             break;
         case ERR_FILE:
-            printf( "Error: could not open file\n");
+            report("Error: could not open file\n");
+            break;
+        case ERR_LIMIT:
+            report("Error: execution limit exceeded\n");
+            break;
+        case ERR_MACRO:
+            report("Error: undefined or malformed macro\n");
             break;
         case ERR_UNKNOWN: default:
-            printf( "Error: unknown error\n");
+            report("Error: unknown error\n");
             break;
     }
     return err;
 }
 
+/* Starts copying the output of a script that reads no input to the cache */
+static void record_run(const Options* opts, unsigned long long key){
+    if (opts->cache_dir && !opts->debug) ctx->output_copy = record_output(opts->cache_dir, key);
+}
+
 
-Error readfile(const char* filename){
+Error readfile(const char* filename, const Options* opts){
     /* Open script */
     Error err = ERR_OK;
     FILE* file = NULL;
     file = fopen(filename, "rb");
     if(!file){
-        printf( "Error: Unable to open file '%s'\n", filename);
+        report("Error: Unable to open file '%s'\n", filename);
         return ERR_FILE;
     }
 
-    /* Check for unmatched brackets */
-    int where_err = 0;
-    if ( check_matching_brackets(file, '[', ']', &where_err) != ERR_OK
-         || check_matching_brackets(file, '(' , ')', &where_err) != ERR_OK
-       ){
-        printf( "Error: missing matching bracket at character %d\n", where_err);
-        fclose(file);
-        return ERR_MATCHING_BRACKET;
+    /* Load script into memory */
+    size_t script_size = 0;
+    char* script = load_file(file, &script_size);
+    fclose(file);
+    if(!script){
+        report("Error: Unable to read file '%s'\n", filename);
+        return ERR_FILE;
     }
-    
+
+    /* Inline macros and imports, so that every later stage sees plain code */
+    Expansion exp;
+    err = expand_macros(script, script_size, &exp);
+    int line = 0, column = 0;
+    if (err != ERR_OK){
+        locate(script, exp.where, &line, &column);
+        report("Error: %s at line %d, column %d\n", exp.problem, line, column);
+        free(script);
+        return err;
+    }
+    const char* src = exp.src;
+    size_t size = exp.size;
+
+    /* Output cached from an earlier run of the same script, which read no input */
+    unsigned long long key = (opts->cache_dir || checkpoint_file || opts->resume) ? hash_script(src, size) : 0;
+    if (opts->no_optimize) key = hash_bytes(&opts->no_optimize, sizeof(opts->no_optimize), key); // cached apart from optimized code
+    ctx->key = key;
+    if (opts->cache_dir && !opts->debug && !opts->emit_c && !opts->profile && !opts->resume && replay_output(opts->cache_dir, key)){
+        free_expansion(&exp);
+        free(script);
+        return ERR_OK;
+    }
+
+    /* Program compiled by an earlier run, which needs no further parsing */
+    Program prog;
+    int cached = !opts->naive && !opts->profile && opts->cache_dir && load_program(opts->cache_dir, key, &prog);
+
+    /* Check for unmatched brackets and build the jump table */
+    size_t where_err = 0;
+    int reads = 1;
+    size_t* jumps = NULL;
+    if (!cached){
+        jumps = malloc((size > 0 ? size : 1) * sizeof(size_t));
+        if(!jumps){
+            free_expansion(&exp);
+            free(script);
+            return manage_error(ERR_UNKNOWN);
+        }
+        if ( check_matching_brackets(src, size, jumps, &where_err, &reads) != ERR_OK ){
+            locate(script, exp.origin ? exp.origin[where_err] : where_err, &line, &column);
+            report("Error: missing matching bracket '%c' at line %d, column %d\n", src[where_err], line, column);
+            free(jumps);
+            free_expansion(&exp);
+            free(script);
+            return ERR_MATCHING_BRACKET;
+        }
+    }
+
     /* Read and execute commands */
-    err = interpret_file(file);
+    if (opts->stats) start_stats();
+    if (opts->profile){
+        size_t* where = malloc(PROGRAM_MAX_LEN(size) * sizeof(size_t));
+        err = where ? compile_program(src, size, jumps, &prog, where) : ERR_UNKNOWN;
+        if (err == ERR_OK){
+            size_t ip;
+            // loops are reported where they are in the script, those of macros where they are called
+            for(ip = 0; ip < prog.len && exp.origin; ++ip) where[ip] = exp.origin[where[ip]];
+            err = profile_program(&prog, where, script, opts->profile);
+            free_program(&prog);
+        }
+        free(where);
+    }
+    else if (opts->naive && !opts->resume){ // checkpoints are taken by the compiled engines only
+        if (!reads) record_run(opts, key);
+        err = interpret_file(src, size, jumps);
+    }
+    else{
+        if (!cached){
+            err = compile_program(src, size, jumps, &prog, NULL);
+            if (err == ERR_OK){
+                if (!opts->no_optimize) optimize_program(&prog);
+                if (opts->cache_dir) save_program(opts->cache_dir, key, &prog);
+            }
+        }
+        if (err == ERR_OK){
+            JitCode jit = {0};
+            if (opts->emit_c){
+                FILE* out = open_output_stream();
+                err = out ? emit_c(&prog, out) : ERR_UNKNOWN;
+                if (out) fclose(out);
+            }
+            else{
+                int variant = budget_enabled() | stats_enabled << 1; // code checking its budget, or tracking the stack pointer
+                unsigned long long jit_key = hash_bytes(&variant, sizeof(variant), key);
+                // block spans are kept whole for --stats, which widens the extremes of the stack pointer by them
+                if (stack_guarded && !stats_enabled) relax_bounds_checks(&prog, stack_guard_below(), STACK_GUARD >> cell_shift);
+                Program run = prog; // starts where a checkpoint left off, if resuming
+                if (opts->resume) err = resume_checkpoint(opts->resume, &run);
+                else{
+                    if (!program_reads_input(&prog)) record_run(opts, key);
+                    load_prefix(&prog);
+                }
+                // resumed code starts within the program, so it is not cached
+                int cache_jit = opts->cache_dir && !opts->resume;
+                if (err == ERR_OK && opts->jit && !(cache_jit && load_jit(opts->cache_dir, jit_key, &jit))){
+                    if (jit_compile(&run, &jit) && cache_jit) save_jit(opts->cache_dir, jit_key, &jit);
+                }
+                if (jit.code){
+                    err = run_guarded(jit_run, &jit);
+                    jit_free(&jit);
+                }
+                else if (err == ERR_OK){
+                    err = run_guarded(execute_program, &run);
+                }
+            }
+            free_program(&prog);
+        }
+    }
+    flush_output();
+    if (opts->stats) stop_stats();
+    if (ctx->output_copy){
+        finish_record(opts->cache_dir, key, ctx->output_copy, err == ERR_OK);
+        ctx->output_copy = NULL;
+    }
     manage_error(err);
-    fclose(file);
+    free(jumps);
+    free_expansion(&exp);
+    free(script);
     return err;
 }
 
 
+#ifndef BRAINDUCK_LIBRARY
 int main(int argc, char* argv[]){
      
     if (argc < 2){
         printf("Error: no input file specified.\n");
         return ERR_FILE;
     }
-    int code = readfile(argv[1]);    
+    Options opts = {0};
+    Profile profile = {0};
+    ProfileFormat profile_format = PROFILE_TABLE;
+    const char* stats_file = NULL;
+    const char* input_file = NULL; // mapped for ',' to read from instead of stdin
+    const char* value = NULL;
+    int i;
+    for(i = 2; i < argc; ++i){
+        if (strcmp(argv[i], "--debug") == 0) opts.debug = 1;
+        else if (strcmp(argv[i], "--naive") == 0) opts.naive = 1;
+        else if (strcmp(argv[i], "--jit") == 0) opts.jit = 1;
+        else if (strcmp(argv[i], "--emit-c") == 0) opts.emit_c = 1;
+        else if (strcmp(argv[i], "--no-optimize") == 0) opts.no_optimize = 1;
+        else if (strcmp(argv[i], "--unbuffered") == 0) output_unbuffered = 1;
+        else if (strcmp(argv[i], "--stream") == 0) input_mode = INPUT_STREAM;
+        else if (strcmp(argv[i], "--eof=0") == 0) input_eof = EOF_ZERO;
+        else if (strcmp(argv[i], "--eof=-1") == 0) input_eof = EOF_MINUS_ONE;
+        else if (strcmp(argv[i], "--eof=unchanged") == 0) input_eof = EOF_UNCHANGED;
+        else if (strcmp(argv[i], "--grow") == 0) stack_growable = 1;
+        else if (strcmp(argv[i], "--guard-pages") == 0) stack_guarded = 1;
+        else if (strcmp(argv[i], "--cell-bits=8") == 0) cell_shift = 0;
+        else if (strcmp(argv[i], "--cell-bits=16") == 0) cell_shift = 1;
+        else if (strcmp(argv[i], "--cell-bits=32") == 0) cell_shift = 2;
+        else if (strcmp(argv[i], "--batch") == 0) opts.batch = 1;
+        else if (strcmp(argv[i], "--profile") == 0) opts.profile = &profile;
+        else if (strcmp(argv[i], "--stats") == 0) opts.stats = 1;
+        else if ((value = option_value(argv[i], "--stats"))){
+            opts.stats = 1;
+            stats_file = value;
+        }
+        else if (strcmp(argv[i], "--profile=json") == 0){
+            opts.profile = &profile;
+            profile_format = PROFILE_JSON;
+        }
+        else if ((value = option_value(argv[i], "--cache"))) opts.cache_dir = value;
+        else if ((value = option_value(argv[i], "--input"))) input_file = value;
+        else if ((value = option_value(argv[i], "--checkpoint"))) checkpoint_file = value;
+        else if ((value = option_value(argv[i], "--resume"))) opts.resume = value;
+        else if (strcmp(argv[i], "--parallel") == 0) parallel_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        else if ((value = option_value(argv[i], "--parallel"))){
+            char* end = NULL;
+            parallel_threads = (int)strtol(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || parallel_threads <= 0){
+                printf("Error: invalid thread count '%s'\n", value);
+                return ERR_UNKNOWN;
+            }
+        }
+        else if ((value = option_value(argv[i], "--threads"))){
+            char* end = NULL;
+            opts.threads = (int)strtol(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || opts.threads <= 0){
+                printf("Error: invalid thread count '%s'\n", value);
+                return ERR_UNKNOWN;
+            }
+        }
+        else if ((value = option_value(argv[i], "--max-steps"))){
+            char* end = NULL;
+            max_steps = strtoull(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || max_steps == 0){
+                printf("Error: invalid step limit '%s'\n", value);
+                return ERR_UNKNOWN;
+            }
+        }
+        else if ((value = option_value(argv[i], "--timeout-ms"))){
+            char* end = NULL;
+            timeout_ms = strtol(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || timeout_ms <= 0){
+                printf("Error: invalid timeout '%s'\n", value);
+                return ERR_UNKNOWN;
+            }
+        }
+        else if ((value = option_value(argv[i], "--tape-size"))){
+            char* end = NULL;
+            tape_size = strtoul(value, &end, 10);
+            if (*value == '\0' || *end != '\0' || tape_size == 0){
+                printf("Error: invalid tape size '%s'\n", value);
+                return ERR_UNKNOWN;
+            }
+        }
+        else{
+            printf("Error: unknown option '%s'\n", argv[i]);
+            return ERR_UNKNOWN;
+        }
+    }
+
+    if (stack_growable) stack_guarded = 0; // a growing stack has to be able to move
+    if (opts.batch){
+        opts.profile = NULL; // jobs would all count into the same profile
+        opts.stats = 0;
+        opts.resume = NULL; // a checkpoint belongs to a single run
+        checkpoint_file = NULL;
+        return run_batch(argv[1], &opts);
+    }
+
+    stats_enabled = opts.stats;
+    if (checkpoint_file) watch_checkpoints();
+    if (!create_context(read_fd, (void*)(long)STDIN_FILENO, write_fd, (void*)(long)STDOUT_FILENO)){
+        printf("Error: unknown error\n");
+        return ERR_UNKNOWN;
+    }
+    if (input_file && map_input(input_file) != ERR_OK){
+        printf("Error: Unable to open file '%s'\n", input_file);
+        destroy_context(ctx);
+        return ERR_FILE;
+    }
+    int code = readfile(argv[1], &opts);
     
-    if (argc >= 3 && strcmp(argv[2], "--debug") == 0){
+    if (opts.debug){
         printf("\n --- Stack debug mode ---\n");
         debug_stack(10);
     }
+    if (opts.profile){
+        print_profile(&profile, profile_format);
+        free_profile(&profile);
+    }
+    if (opts.stats){
+        FILE* out = stats_file ? fopen(stats_file, "w") : stdout;
+        if (!stats_file) printf("\n --- Stats ---\n");
+        if (out) print_stats(out);
+        else printf("Error: Unable to open file '%s'\n", stats_file);
+        if (out && out != stdout) fclose(out);
+    }
+    destroy_context(ctx);
     return code;
 }
-
-
-
-
+#endif /* BRAINDUCK_LIBRARY */
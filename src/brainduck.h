@@ -0,0 +1,333 @@
+#ifndef BRAINDUCK_H
+#define BRAINDUCK_H
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STACK_SIZE 1000 // default number of cells
+#define STACK_GUARD 65536 // bytes of guard pages on each side of a guarded stack
+#define OUTPUT_SIZE 65536 // bytes of output buffered before writing to stdout
+#define INPUT_SIZE 65536  // most bytes of input read from stdin at once
+#define NUMBER_SIZE 20 // most digits of a cell printed by ':'
+
+//#define DEBUG 1
+//#define STATS 1 // count instructions and loop iterations for --stats
+
+/* Adds n to a counter of the current execution, in builds with STATS defined only */
+#ifdef STATS
+#define COUNT(counter, n) (ctx->stats.counter += (unsigned long long)(n))
+#else
+#define COUNT(counter, n) ((void)0)
+#endif
+
+#define STATS_EVENTS 3 // hardware counters read by --stats
+
+typedef enum error_code {
+    ERR_OK = 0,
+    ERR_UNKNOWN_CHAR,
+    ERR_MATCHING_BRACKET,
+    ERR_BOUNDS,
+    ERR_FILE,
+    ERR_UNKNOWN,
+    ERR_LIMIT, // ran for more steps or time than allowed
+    ERR_MACRO // undefined or malformed macro or import
+} Error;
+
+/* Bytecode instructions */
+/*
+Cells are addressed relative to the stack pointer, which only moves
+at the end of a basic block. Loop brackets check that the block they
+lead into stays within the stack, so the instructions within do not.
+A block that moves on after I/O is split there by OP_CHECK, so that
+output and input before a bounds error still happen, as they would
+running the script one command at a time.
+*/
+typedef enum op_code {
+    OP_ADD,    // add arg to cell at offset
+    OP_MOVE,   // move stack pointer by arg cells, passing through the cells from offset to src
+    OP_OUT,    // print cell at offset
+    OP_IN,     // read input into cell at offset
+    OP_OPEN,   // if current cell is zero, jump to instruction arg
+    OP_CLOSE,  // if current cell is not zero, jump back to instruction arg
+    OP_CLEAR,  // set cell at offset to zero, replacing a loop that added arg to it each time round
+    OP_MULADD, // add cell at src times arg to the cell at offset
+    OP_SCAN,   // move stack pointer by arg cells until the current cell is zero
+    OP_ADDS,   // add the src cells of data at byte arg to the cells from offset on
+    OP_OUT_NUM, // print cell at offset in decimal
+    OP_IN_NUM, // read an integer from input into cell at offset
+    OP_CHECK   // check that the rest of the block, reaching cells lo to hi, stays within the stack
+} OpCode;
+
+typedef struct instr {
+    OpCode op;
+    int arg;
+    union {
+        struct {
+            int offset; // cell operated on, relative to the stack pointer, or lowest cell an OP_MOVE passes
+            int src;    // cell read by OP_MULADD, relative to the stack pointer, OP_ADDS count, or highest cell an OP_MOVE passes
+        };
+        struct {
+            int lo, hi; // OP_OPEN/OP_CLOSE/OP_SCAN/OP_CHECK: span of cells reached by the block that follows
+        };
+    };
+    unsigned steps; // OP_CLOSE: commands of the loop, its ']' included, counted by --max-steps each time round; OP_CLEAR/OP_SCAN: those of the loop replaced
+} Instr;
+
+/* Most instructions a script of size bytes compiles to: one per byte, and a check after each other one */
+#define PROGRAM_MAX_LEN(size) ((size) + (size) / 2 + 1)
+
+/* Compiled script */
+typedef struct program {
+    Instr* code;
+    size_t len;
+    int lo, hi; // span of cells reached by the first block
+    char* data; // constant cells used by OP_ADDS, in the current cell width
+    size_t data_len; // in bytes
+    size_t entry; // first instruction to run, after the prefix folded at compile time
+    long entry_pos; // stack pointer on entry, in cells
+    char* tape; // cells set by the folded prefix, in the current cell width
+    size_t tape_len; // in bytes
+    char* output; // bytes printed by the folded prefix
+    size_t output_len;
+    unsigned long long entry_steps; // steps of --max-steps the folded prefix took
+    int reach_lo, reach_hi; // span of cells any instruction reaches from the stack pointer
+    void* mapping; // cache file holding all of the above, if loaded from one
+    size_t mapping_size;
+} Program;
+
+/* Native code generated from a program */
+typedef struct jit_code {
+    void* code;
+    size_t size;
+} JitCode;
+
+/* What ',' consumes from stdin */
+typedef enum input_mode {
+    INPUT_LINE,  // a whole line, keeping its first byte
+    INPUT_STREAM // a single byte
+} InputMode;
+
+/* What ',' stores at the end of input */
+typedef enum eof_mode {
+    EOF_ZERO,
+    EOF_MINUS_ONE,
+    EOF_UNCHANGED
+} EofMode;
+
+/* Execution counts of one loop of a script */
+typedef struct loop_profile {
+    int line, column; // of its '[', counted from 1
+    int end_line, end_column; // of its ']'
+    unsigned long long entries; // times the loop was reached
+    unsigned long long iterations; // times its body ran
+    unsigned long long steps; // instructions run within it, nested loops included
+} LoopProfile;
+
+/* Where a run of a script spent its time */
+typedef struct profile {
+    unsigned long long steps; // instructions run in all
+    LoopProfile* loops; // hottest first
+    size_t loop_count;
+} Profile;
+
+/* What --stats reports about a run */
+typedef struct stats {
+    unsigned long long steps; // instructions run by the interpreters, with STATS defined
+    unsigned long long iterations; // loop iterations, with STATS defined
+    unsigned long long bytes_in; // consumed from the input
+    unsigned long long bytes_out; // written to the output
+    long stack_lo, stack_hi; // cells the stack pointer has been on lie within [lo, hi), counted from the first cell of the stack as it started
+    int events[STATS_EVENTS]; // perf_event_open descriptors while running, or -1
+    long long counts[STATS_EVENTS]; // hardware counts, or -1 where unavailable
+} Stats;
+
+/* How --profile prints its report */
+typedef enum profile_format {
+    PROFILE_TABLE,
+    PROFILE_JSON
+} ProfileFormat;
+
+/* Script with its macros and imports expanded */
+typedef struct expansion {
+    const char* src; // expanded script, or the original one if it had nothing to expand
+    size_t size;
+    size_t* origin; // position in the original script of each byte of src, or NULL if it is the original
+    size_t where; // on failure, position in the original script of what could not be expanded
+    const char* problem; // on failure, what was wrong with it
+} Expansion;
+
+/* Command line options */
+typedef struct options {
+    int debug; // print stack at exit
+    int naive; // interpret the source directly instead of compiling it
+    int jit;   // run the program as native code where supported
+    int no_optimize; // run the bytecode as compiled, without the optimizer passes
+    int stats; // gather statistics about the run
+    int emit_c; // print the program as C source instead of running it
+    const char* cache_dir; // replay the output of scripts without input from here
+    int batch; // run the jobs of a manifest instead of a single script
+    int threads; // workers running batch jobs, or 0 for one per processor
+    Profile* profile; // filled in with the execution counts of the script, if not NULL
+    const char* resume; // checkpoint to carry on the run from, or NULL
+} Options;
+
+
+/* State of one execution of a script: its stack and its I/O */
+typedef struct context {
+    char* stack; // stack buffer
+    char* stackptr; // stack pointer, a byte address
+    size_t stack_size; // number of cells
+    char* guard_region; // mapping holding a guarded stack and its guard pages
+    size_t guard_region_size;
+    size_t touched_lo, touched_hi; // cells written since the stack was last cleared lie within [lo, hi)
+    char *reached_lo, *reached_hi; // lowest and highest cells the stack pointer has been on, or NULL before a run
+    size_t stack_origin; // index of what was the first cell of the stack when last cleared, before it grew below that
+    long (*read)(void* in, char* buf, size_t size); // reads up to size bytes of input, 0 at its end
+    long (*write)(void* out, const char* buf, size_t size); // writes out all of buf, or fails with -1
+    void* in; // passed to read
+    void* out; // passed to write
+    FILE* output_copy; // also receives all output, when recording it to the cache
+    char output[OUTPUT_SIZE]; // bytes printed but not yet written out
+    size_t output_len;
+    char input[INPUT_SIZE]; // bytes read but not yet consumed
+    const char* input_data; // the input buffer, or the mapping of an input file, from input_pos to input_len
+    size_t input_pos, input_len;
+    unsigned long long input_total; // bytes of input read or mapped so far, the unconsumed ones included
+    void* input_map; // input file mapped by map_input, if any
+    size_t input_map_size;
+    Stats stats; // of the current run, with --stats
+    long budget; // steps the run may take in loops before refill_budget is called
+    long granted; // the budget when last handed out
+    unsigned long long steps_left; // of --max-steps, beyond the budget granted
+    unsigned long long prefix_steps; // of --max-steps, taken by the prefix of the program folded at compile time
+    long long deadline; // of --timeout-ms, in nanoseconds of CLOCK_MONOTONIC
+    unsigned long long key; // identifies the script and options in checkpoints of the run
+} Context;
+
+extern _Thread_local Context* ctx; // execution running on this thread
+
+/* Settings shared by every execution */
+extern size_t tape_size; // number of cells in a new stack
+extern int cell_shift; // log2 of the bytes per cell: 8, 16 or 32-bit cells
+extern int stack_growable; // extend the stack on demand instead of failing
+extern int stack_guarded; // surround the stack with inaccessible pages
+extern int output_unbuffered; // write each byte as soon as it is printed
+extern InputMode input_mode;
+extern EofMode input_eof;
+extern unsigned long long max_steps; // most steps a run may take in loops, or 0 for no limit
+extern long timeout_ms; // most milliseconds a run may take, or 0 for no limit
+extern int stats_enabled; // --stats is on, so that the JIT records where the stack pointer goes
+extern int parallel_threads; // threads running independent segments of a program at once, or 0 to run it in order
+extern const char* checkpoint_file; // where SIGUSR1 saves the state of the run, or NULL
+extern volatile sig_atomic_t checkpoint_requested; // set by SIGUSR1 until the checkpoint is saved
+
+/* brainduck.c */
+long input_byte(long current);
+long input_number(long current);
+size_t format_number(char* buf, unsigned long value);
+void print_number(unsigned long value);
+void print_byte(char c);
+void print_bytes(const char* data, size_t len);
+void flush_output();
+unsigned long long input_consumed();
+void report(const char* format, ...);
+size_t findc(const char* src, size_t size, size_t i, char c);
+Error check_matching_brackets(const char* src, size_t size, size_t* jumps, size_t* where, int* reads);
+char* load_file(FILE* file, size_t* size);
+Error readfile(const char* filename, const Options* opts);
+
+/* context.c */
+Context* create_context(long (*read)(void*, char*, size_t), void* in,
+                        long (*write)(void*, const char*, size_t), void* out);
+void destroy_context(Context* context);
+long read_fd(void* in, char* buf, size_t size);
+long write_fd(void* out, const char* buf, size_t size);
+long write_file(void* out, const char* buf, size_t size);
+Error map_input(const char* filename);
+FILE* open_output_stream();
+
+/* macro.c */
+Error expand_macros(const char* src, size_t size, Expansion* exp);
+void free_expansion(Expansion* exp);
+
+/* tape.c */
+Error init_stack();
+void free_stack();
+Error check_cell(long offset);
+unsigned long get_cell(const char* p);
+void set_cell(char* p, unsigned long value);
+Error run_guarded(Error (*run)(const void*), const void* arg);
+int stack_guard_below();
+void touch_cells(const char* low, const char* high, long lo, long hi);
+void touch_stack();
+void clear_stack();
+
+/* compile.c */
+Error compile_program(const char* src, size_t size, const size_t* jumps, Program* prog, size_t* where);
+void set_block_range(Program* prog, long head, int lo, int hi);
+int program_reads_input(const Program* prog);
+void free_program(Program* prog);
+
+/* optimize.c */
+void optimize_program(Program* prog);
+void relax_bounds_checks(Program* prog, int below, int above);
+
+/* limit.c */
+int budget_enabled();
+Error start_limits();
+Error refill_budget();
+Error charge_steps(unsigned long long steps);
+
+/* snapshot.c */
+void watch_checkpoints();
+void save_checkpoint(size_t open);
+Error resume_checkpoint(const char* filename, Program* run);
+
+/* scan.c */
+Error scan_stack(long stride, unsigned steps);
+
+/* vector.c */
+void add_cells(char* dst, const char* deltas, size_t count);
+
+/* cache.c */
+unsigned long long hash_bytes(const void* data, size_t size, unsigned long long h);
+unsigned long long hash_script(const char* src, size_t size);
+int replay_output(const char* dir, unsigned long long key);
+FILE* record_output(const char* dir, unsigned long long key);
+void finish_record(const char* dir, unsigned long long key, FILE* file, int keep);
+int load_program(const char* dir, unsigned long long key, Program* prog);
+void save_program(const char* dir, unsigned long long key, const Program* prog);
+int load_jit(const char* dir, unsigned long long key, JitCode* jit);
+void save_jit(const char* dir, unsigned long long key, const JitCode* jit);
+
+/* batch.c */
+int run_batch(const char* manifest, const Options* opts);
+
+/* execute.c */
+Error execute_program(const void* program); // runs a Program
+Error execute_serial(const Program* prog);
+void load_prefix(const Program* prog);
+
+/* parallel.c */
+Error execute_parallel(const Program* prog);
+
+/* profile.c */
+Error profile_program(const Program* prog, const size_t* where, const char* src, Profile* profile);
+void print_profile(const Profile* profile, ProfileFormat format);
+void free_profile(Profile* profile);
+
+/* stats.c */
+void start_stats();
+void stop_stats();
+void print_stats(FILE* out);
+
+/* emitc.c */
+Error emit_c(const Program* prog, FILE* out);
+
+/* jit.c */
+int jit_compile(const Program* prog, JitCode* jit);
+Error jit_run(const void* code); // runs a JitCode
+void jit_free(JitCode* jit);
+
+#endif /* BRAINDUCK_H */
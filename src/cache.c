@@ -0,0 +1,292 @@
+#define _GNU_SOURCE // O_DIRECTORY, O_NOFOLLOW and openat
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+/*
+On-disk cache of what a script compiles to, and of the output of scripts
+that read no input, which only depends on the source and on the options
+that shape the stack or limit the run.
+Entries are named after a hash of both. They are written under a
+temporary name and renamed once complete, so a concurrent run never
+loads a partial entry. Only a directory and entries owned by the
+current user and writable by no one else are used, since native code
+and bytecode with unchecked jumps are run straight from them.
+*/
+
+#define CACHE_PATH_SIZE 4096
+#define CACHE_NAME_SIZE 128 // of an entry within the cache directory
+#define CACHE_VERSION 7 // bumped whenever the layout of compiled programs or of the key changes
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME  1099511628211ULL
+
+/* 64-bit FNV-1a hash of size bytes, continuing from h */
+unsigned long long hash_bytes(const void* data, size_t size, unsigned long long h){
+    const unsigned char* p = data;
+    size_t i;
+    for(i = 0; i < size; ++i){
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+/* Hash of a script together with the options that change what it prints */
+unsigned long long hash_script(const char* src, size_t size){
+    unsigned long long h = hash_bytes(src, size, FNV_OFFSET);
+    int version = CACHE_VERSION;
+    h = hash_bytes(&version, sizeof(version), h);
+    h = hash_bytes(&cell_shift, sizeof(cell_shift), h);
+    h = hash_bytes(&tape_size, sizeof(tape_size), h);
+    h = hash_bytes(&stack_growable, sizeof(stack_growable), h);
+    h = hash_bytes(&stack_guarded, sizeof(stack_guarded), h);
+    h = hash_bytes(&max_steps, sizeof(max_steps), h);
+    h = hash_bytes(&timeout_ms, sizeof(timeout_ms), h);
+    return h;
+}
+
+static void entry_name(char* name, unsigned long long key, const char* ext){
+    snprintf(name, CACHE_NAME_SIZE, "%016llx%s", key, ext);
+}
+
+/* Checks that fd is of the given type, belongs to the current user and cannot be written by anyone else */
+static int trusted(int fd, mode_t type){
+    struct stat st;
+    return fstat(fd, &st) == 0 && (st.st_mode & S_IFMT) == type
+        && st.st_uid == geteuid() && !(st.st_mode & (S_IWGRP | S_IWOTH));
+}
+
+/*
+Opens the cache directory, creating it if asked to. Returns -1 unless it
+is trusted, as native code is run straight from it and anyone else able
+to write there could swap it for their own.
+*/
+static int open_dir(const char* dir, int create){
+    int fd;
+    if (create) mkdir(dir, 0700);
+    fd = open(dir, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0 && !trusted(fd, S_IFDIR)){
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+/* Opens an entry for reading, without following links. Returns -1 unless it and its directory are trusted */
+static int open_trusted(const char* dir, unsigned long long key, const char* ext){
+    char name[CACHE_NAME_SIZE];
+    int dirfd = open_dir(dir, 0), fd = -1;
+    if (dirfd < 0) return -1;
+    entry_name(name, key, ext);
+    fd = openat(dirfd, name, O_RDONLY | O_NOFOLLOW);
+    close(dirfd);
+    if (fd >= 0 && !trusted(fd, S_IFREG)){
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+/* Writes the cached output for key to the output of the current context. Returns 1 if there was one */
+int replay_output(const char* dir, unsigned long long key){
+    char buf[OUTPUT_SIZE];
+    ssize_t n;
+    int fd = open_trusted(dir, key, ".out");
+    if (fd < 0) return 0;
+    while((n = read(fd, buf, sizeof(buf))) > 0) ctx->write(ctx->out, buf, (size_t)n);
+    close(fd);
+    return 1;
+}
+
+/* Name of the temporary file of a new entry, unique to this process and context */
+static void temp_name(char* name, unsigned long long key, const char* ext){
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%s.%ld.%p.tmp", ext, (long)getpid(), (void*)ctx);
+    entry_name(name, key, tmp);
+}
+
+/* Opens a temporary file for a new entry, creating the cache directory if needed. Returns NULL unless it is trusted */
+static FILE* open_entry(const char* dir, unsigned long long key, const char* ext){
+    char name[CACHE_NAME_SIZE];
+    int dirfd = open_dir(dir, 1), fd;
+    FILE* file;
+    if (dirfd < 0) return NULL;
+    temp_name(name, key, ext);
+    fd = openat(dirfd, name, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0600);
+    close(dirfd);
+    if (fd < 0) return NULL;
+    file = fdopen(fd, "wb");
+    if (!file) close(fd);
+    return file;
+}
+
+/* Closes an entry opened by open_entry, and keeps it under its final name if asked to */
+static void close_entry(const char* dir, unsigned long long key, const char* ext, FILE* file, int keep){
+    char path[CACHE_PATH_SIZE], done[CACHE_PATH_SIZE], tmp[CACHE_NAME_SIZE], name[CACHE_NAME_SIZE];
+    temp_name(tmp, key, ext);
+    entry_name(name, key, ext);
+    snprintf(path, sizeof(path), "%s/%s", dir, tmp);
+    snprintf(done, sizeof(done), "%s/%s", dir, name);
+    if (fclose(file) != 0) keep = 0;
+    if (!keep || rename(path, done) != 0) remove(path);
+}
+
+/* Maps a whole trusted entry into memory. Returns NULL if there is none */
+static void* map_entry(const char* dir, unsigned long long key, const char* ext, int prot, size_t* size){
+    struct stat st;
+    void* map;
+    int fd = open_trusted(dir, key, ext);
+
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0){
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    *size = (size_t)st.st_size;
+    return map;
+}
+
+/* Opens a new output entry for key. Returns NULL on failure */
+FILE* record_output(const char* dir, unsigned long long key){
+    return open_entry(dir, key, ".out");
+}
+
+/* Closes an output entry, keeping it only if the run succeeded */
+void finish_record(const char* dir, unsigned long long key, FILE* file, int keep){
+    close_entry(dir, key, ".out", file, keep);
+}
+
+/* Layout of a compiled program entry, followed by its code, data, tape and output */
+typedef struct program_header {
+    char magic[8];
+    unsigned long long key;
+    size_t len, data_len, tape_len, output_len;
+    size_t entry;
+    long entry_pos;
+    unsigned long long entry_steps;
+    int lo, hi;
+    int reach_lo, reach_hi;
+} ProgramHeader;
+
+static const char program_magic[8] = "BDPROG";
+
+/*
+Maps the program compiled for key, so that it runs without any parsing.
+The mapping is private and writable, as later passes patch the code.
+Returns 1 on success, 0 if there is no valid entry.
+*/
+int load_program(const char* dir, unsigned long long key, Program* prog){
+    size_t size = 0, need;
+    char* map = map_entry(dir, key, ".prog", PROT_READ | PROT_WRITE, &size);
+    ProgramHeader head;
+
+    if (!map) return 0;
+    if (size < sizeof(head)) goto invalid;
+    memcpy(&head, map, sizeof(head));
+    need = sizeof(head) + head.len * sizeof(Instr) + head.data_len + head.tape_len + head.output_len;
+    if (memcmp(head.magic, program_magic, sizeof(program_magic)) != 0 || head.key != key || need != size){
+        goto invalid;
+    }
+
+    prog->code = (Instr*)(map + sizeof(head));
+    prog->len = head.len;
+    prog->data = (char*)(prog->code + head.len);
+    prog->data_len = head.data_len;
+    prog->tape = prog->data + head.data_len;
+    prog->tape_len = head.tape_len;
+    prog->output = prog->tape + head.tape_len;
+    prog->output_len = head.output_len;
+    prog->entry = head.entry;
+    prog->entry_pos = head.entry_pos;
+    prog->entry_steps = head.entry_steps;
+    prog->lo = head.lo;
+    prog->hi = head.hi;
+    prog->reach_lo = head.reach_lo;
+    prog->reach_hi = head.reach_hi;
+    prog->mapping = map;
+    prog->mapping_size = size;
+    return 1;
+
+invalid:
+    munmap(map, size);
+    return 0;
+}
+
+/* Stores a compiled program for key. Failures only mean it is compiled again next time */
+void save_program(const char* dir, unsigned long long key, const Program* prog){
+    ProgramHeader head = {{0}, key, prog->len, prog->data_len, prog->tape_len, prog->output_len,
+                          prog->entry, prog->entry_pos, prog->entry_steps, prog->lo, prog->hi,
+                          prog->reach_lo, prog->reach_hi};
+    FILE* file = open_entry(dir, key, ".prog");
+    int ok;
+    if (!file) return;
+    memcpy(head.magic, program_magic, sizeof(program_magic));
+    ok = fwrite(&head, sizeof(head), 1, file) == 1
+      && fwrite(prog->code, sizeof(Instr), prog->len, file) == prog->len
+      && fwrite(prog->data, 1, prog->data_len, file) == prog->data_len
+      && fwrite(prog->tape, 1, prog->tape_len, file) == prog->tape_len
+      && fwrite(prog->output, 1, prog->output_len, file) == prog->output_len;
+    close_entry(dir, key, ".prog", file, ok);
+}
+
+/* Layout of a native code entry: the header, padded to a page, then the code */
+typedef struct jit_header {
+    char magic[8];
+    unsigned long long key;
+    int version;
+    size_t offset; // of the code, a whole page
+    size_t size; // of the code
+} JitHeader;
+
+static const char jit_magic[8] = "BDJIT";
+
+/*
+Maps native code generated for key straight from the cache as executable,
+which works because the code does not depend on where it is loaded.
+The entry is mapped read-only until its header has been checked.
+Returns 1 on success, 0 if there is no valid entry.
+*/
+int load_jit(const char* dir, unsigned long long key, JitCode* jit){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = 0;
+    char* map = map_entry(dir, key, ".jit", PROT_READ, &size);
+    JitHeader head;
+
+    if (!map) return 0;
+    if (size < sizeof(head)) goto invalid;
+    memcpy(&head, map, sizeof(head));
+    if (memcmp(head.magic, jit_magic, sizeof(jit_magic)) != 0 || head.key != key || head.version != CACHE_VERSION
+        || head.offset != page || head.size == 0 || head.size != size - head.offset || size <= head.offset){
+        goto invalid;
+    }
+    if (mprotect(map + head.offset, head.size, PROT_READ | PROT_EXEC) != 0) goto invalid;
+    munmap(map, head.offset); // the header is no longer needed
+    jit->code = map + head.offset;
+    jit->size = head.size;
+    return 1;
+
+invalid:
+    munmap(map, size);
+    return 0;
+}
+
+/* Stores native code for key, after a header padded to a page so that the code can be mapped on its own */
+void save_jit(const char* dir, unsigned long long key, const JitCode* jit){
+    JitHeader head = {{0}, key, CACHE_VERSION, (size_t)sysconf(_SC_PAGESIZE), jit->size};
+    FILE* file = open_entry(dir, key, ".jit");
+    int ok;
+    if (!file) return;
+    memcpy(head.magic, jit_magic, sizeof(jit_magic));
+    ok = fwrite(&head, sizeof(head), 1, file) == 1
+      && fseek(file, (long)head.offset, SEEK_SET) == 0
+      && fwrite(jit->code, 1, jit->size, file) == jit->size;
+    close_entry(dir, key, ".jit", file, ok);
+}
@@ -0,0 +1,165 @@
+#include <sys/mman.h>
+
+#include "brainduck.h"
+
+/*
+Appends an instruction to the program.
+Runs of '+' '-' and of '>' '<' are folded into a single instruction
+carrying the net count. Additions that cancel out are dropped, while
+a run of moves keeps the lowest and highest cell it passes through,
+since a move such as <> may leave the stack even if it ends where it started.
+*/
+static void emit(Program* prog, OpCode op, int arg){
+    if ((op == OP_ADD || op == OP_MOVE) && prog->len > 0){
+        Instr* last = &prog->code[prog->len - 1];
+        if (last->op == op){
+            last->arg += arg;
+            if (op == OP_ADD && last->arg == 0) prog->len--;
+            if (op == OP_MOVE && last->arg < last->offset) last->offset = last->arg;
+            if (op == OP_MOVE && last->arg > last->src) last->src = last->arg;
+            return;
+        }
+    }
+    prog->code[prog->len].op = op;
+    prog->code[prog->len].arg = arg;
+    prog->code[prog->len].offset = (op == OP_MOVE && arg < 0) ? arg : 0;
+    prog->code[prog->len].src = (op == OP_MOVE && arg > 0) ? arg : 0;
+    prog->code[prog->len].steps = 0;
+    prog->len++;
+}
+
+/*
+Stores the span of cells reached by a basic block,
+relative to the stack pointer on entry, in the loop bracket or scan
+that precedes it, or in the program itself for the first block.
+*/
+void set_block_range(Program* prog, long head, int lo, int hi){
+    if (head < 0){
+        prog->lo = lo;
+        prog->hi = hi;
+    }
+    else{
+        prog->code[head].lo = lo;
+        prog->code[head].hi = hi;
+    }
+}
+
+/*
+Translates the script into bytecode.
+Comments and whitespace are stripped, and loop brackets are resolved
+into instruction indices. The script must have been validated by
+check_matching_brackets, which provides the jump table used to skip comments.
+If where is not NULL, it receives the source position of each instruction:
+the byte of the script that starts it, for PROGRAM_MAX_LEN(size) entries at most.
+*/
+Error compile_program(const char* src, size_t size, const size_t* jumps, Program* prog, size_t* where){
+    int open = -1; // innermost unmatched loop, earlier ones linked through arg
+    long head = -1; // loop bracket or check preceding the current block
+    int pos = 0, lo = 0, hi = 0; // stack pointer movement within the current block
+    int io = 0; // the current block has done I/O, so a move ends it with a check
+    unsigned commands = 0; // of the script so far, kept in the steps of each unmatched '['
+    size_t i;
+
+    // every instruction takes at least one byte of source, but for checks, which each follow a byte of I/O
+    prog->len = 0;
+    prog->data = NULL;
+    prog->data_len = 0;
+    prog->entry = 0;
+    prog->entry_pos = 0;
+    prog->tape = prog->output = NULL;
+    prog->tape_len = prog->output_len = 0;
+    prog->entry_steps = 0;
+    prog->reach_lo = prog->reach_hi = 0;
+    prog->mapping = NULL;
+    prog->mapping_size = 0;
+    prog->code = malloc(PROGRAM_MAX_LEN(size) * sizeof(Instr));
+    if (!prog->code) return ERR_UNKNOWN;
+
+    for(i = 0; i < size; ++i){
+        size_t len = prog->len;
+        if (io && (src[i] == '>' || src[i] == '<')){
+            set_block_range(prog, head, lo, hi);
+            emit(prog, OP_CHECK, 0);
+            head = (long)prog->len - 1;
+            pos = lo = hi = 0;
+            io = 0;
+        }
+        switch(src[i]){
+            case '+': emit(prog, OP_ADD, 1);   break;
+            case '-': emit(prog, OP_ADD, -1);  break;
+            case '>':
+                emit(prog, OP_MOVE, 1);
+                if (++pos > hi) hi = pos;
+                break;
+            case '<':
+                emit(prog, OP_MOVE, -1);
+                if (--pos < lo) lo = pos;
+                break;
+            case '.': emit(prog, OP_OUT, 0);    io = 1; break;
+            case ',': emit(prog, OP_IN, 0);     io = 1; break;
+            case ':': emit(prog, OP_OUT_NUM, 0); io = 1; break;
+            case ';': emit(prog, OP_IN_NUM, 0);  io = 1; break;
+            case '[':
+                set_block_range(prog, head, lo, hi);
+                emit(prog, OP_OPEN, open);
+                open = (int)prog->len - 1;
+                prog->code[open].steps = commands + 1;
+                head = open;
+                pos = lo = hi = 0;
+                io = 0;
+                break;
+            case ']': {
+                int match = open;
+                set_block_range(prog, head, lo, hi);
+                open = prog->code[match].arg;
+                prog->code[match].arg = (int)prog->len;
+                emit(prog, OP_CLOSE, match);
+                prog->code[prog->len - 1].steps = commands + 1 - prog->code[match].steps;
+                prog->code[match].steps = 0;
+                head = (long)prog->len - 1;
+                pos = lo = hi = 0;
+                io = 0;
+                break;
+            }
+            case '(': case '#': i = jumps[i]; continue; // comments
+            case '\n': case '\0': case ' ': case '\r': case '\t': continue;
+            default:
+                free_program(prog);
+                return ERR_UNKNOWN_CHAR;
+        }
+        commands++;
+        if (where && prog->len > len) where[prog->len - 1] = i;
+    }
+    set_block_range(prog, head, lo, hi);
+    return ERR_OK;
+}
+
+/* Checks whether a compiled program may read input */
+int program_reads_input(const Program* prog){
+    size_t ip;
+    for(ip = 0; ip < prog->len; ++ip){
+        if (prog->code[ip].op == OP_IN || prog->code[ip].op == OP_IN_NUM) return 1;
+    }
+    return 0;
+}
+
+void free_program(Program* prog){
+    if (prog->mapping){
+        munmap(prog->mapping, prog->mapping_size);
+    }
+    else{
+        free(prog->code);
+        free(prog->data);
+        free(prog->tape);
+        free(prog->output);
+    }
+    prog->mapping = NULL;
+    prog->mapping_size = 0;
+    prog->code = NULL;
+    prog->data = prog->tape = prog->output = NULL;
+    prog->len = 0;
+    prog->data_len = prog->tape_len = prog->output_len = 0;
+    prog->entry = 0;
+    prog->entry_pos = 0;
+    prog->entry_steps = 0;
+}
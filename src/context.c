@@ -0,0 +1,131 @@
+#define _GNU_SOURCE // fopencookie
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+_Thread_local Context* ctx = NULL; // execution running on this thread
+
+/*
+Creates an execution context with a fresh stack, reading input through
+'read' and writing output through 'write', and makes it current on this
+thread. Returns NULL on failure.
+*/
+Context* create_context(long (*read)(void*, char*, size_t), void* in,
+                        long (*write)(void*, const char*, size_t), void* out){
+    Context* context = malloc(sizeof(Context));
+    int i;
+    if (!context) return NULL;
+    memset(context, 0, sizeof(Context));
+    for(i = 0; i < STATS_EVENTS; ++i){
+        context->stats.events[i] = -1;
+        context->stats.counts[i] = -1;
+    }
+    context->read = read;
+    context->in = in;
+    context->write = write;
+    context->out = out;
+    context->input_data = context->input;
+    ctx = context;
+    if (init_stack() != ERR_OK){
+        free(context);
+        ctx = NULL;
+        return NULL;
+    }
+    return context;
+}
+
+/* Frees a context and its stack, leaving no context current if it was */
+void destroy_context(Context* context){
+    Context* current = ctx;
+    if (!context) return;
+    ctx = context;
+    free_stack();
+    if (context->input_map) munmap(context->input_map, context->input_map_size);
+    free(context);
+    ctx = (current == context) ? NULL : current;
+}
+
+/* Input callback reading from the file descriptor held in 'in' */
+long read_fd(void* in, char* buf, size_t size){
+    ssize_t n;
+    do n = read((int)(long)in, buf, size);
+    while (n < 0 && errno == EINTR);
+    return (long)n;
+}
+
+/* Input callback of a context reading from a mapping, which holds all of the input there is */
+static long read_nothing(void* in, char* buf, size_t size){
+    (void)in;
+    (void)buf;
+    (void)size;
+    return 0;
+}
+
+/*
+Has the current context take its input straight from a mapping of a file,
+instead of reading it into the input buffer bit by bit.
+*/
+Error map_input(const char* filename){
+    struct stat st;
+    int fd = open(filename, O_RDONLY);
+    void* map = NULL;
+
+    if (fd < 0) return ERR_FILE;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+        close(fd);
+        return ERR_FILE;
+    }
+    if (st.st_size > 0){
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED){
+            close(fd);
+            return ERR_FILE;
+        }
+        madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    ctx->input_map = map;
+    ctx->input_map_size = (size_t)st.st_size;
+    ctx->input_data = map ? map : ctx->input;
+    ctx->input_pos = 0;
+    ctx->input_len = (size_t)st.st_size;
+    ctx->input_total += (unsigned long long)st.st_size;
+    ctx->read = read_nothing;
+    ctx->in = NULL;
+    return ERR_OK;
+}
+
+/* Output callback writing to the file descriptor held in 'out', with no copy through stdio */
+long write_fd(void* out, const char* buf, size_t size){
+    size_t done = 0;
+    while(done < size){
+        ssize_t n = write((int)(long)out, buf + done, size - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        done += (size_t)n;
+    }
+    return (long)size;
+}
+
+/* Output callback writing to the stdio stream 'out' */
+long write_file(void* out, const char* buf, size_t size){
+    size_t n = fwrite(buf, 1, size, out);
+    fflush(out);
+    return (n == size) ? (long)n : -1;
+}
+
+static ssize_t stream_write(void* cookie, const char* buf, size_t size){
+    Context* context = cookie;
+    return (context->write(context->out, buf, size) < 0) ? -1 : (ssize_t)size;
+}
+
+/* Opens a stdio stream onto the output of the current context, for bulk text such as emitted C */
+FILE* open_output_stream(){
+    cookie_io_functions_t io = {NULL, stream_write, NULL, NULL};
+    return fopencookie(ctx, "w", io);
+}
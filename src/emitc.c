@@ -0,0 +1,223 @@
+#include "brainduck.h"
+
+/*
+Ahead-of-time translation of a compiled program into a standalone
+C translation unit, which behaves like the interpreter:
+same cell width, stack size and growth, bounds errors and exit codes, and the input mode
+and EOF behaviour of ',' and ';' currently selected.
+Output goes through the stdio buffer. In line mode it is flushed before
+reading input, in stream mode only when full, as suits a pipeline.
+*/
+
+static const char* c_prelude =
+    "#include <stdint.h>\n"
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <string.h>\n"
+    "\n"
+    "#define STACK_SIZE %zu\n"
+    "#define GROWABLE %d\n"
+    "\n"
+    "typedef uint%d_t cell;\n"
+    "\n"
+    "static cell* stack;\n"
+    "static long stack_size = STACK_SIZE;\n"
+    "static cell* p;\n"
+    "\n"
+    "static void bounds_error(void){\n"
+    "    printf(\"Error: stack pointer out of bounds\\n\");\n"
+    "    exit(%d);\n"
+    "}\n"
+    "\n"
+    "/* Makes the cell at offset from the stack pointer exist, growing the stack if allowed */\n"
+    "static void reach(long offset){\n"
+    "    long pos = (p - stack) + offset, index = p - stack, need, extra;\n"
+    "    cell* grown;\n"
+    "    if (pos >= 0 && pos < stack_size) return;\n"
+    "    if (!GROWABLE) bounds_error();\n"
+    "    need = (pos < 0) ? -pos : pos - stack_size + 1;\n"
+    "    extra = (need > stack_size) ? need : stack_size;\n"
+    "    grown = realloc(stack, (stack_size + extra) * sizeof(cell));\n"
+    "    if (!grown) bounds_error();\n"
+    "    if (pos < 0){\n"
+    "        memmove(grown + extra, grown, stack_size * sizeof(cell));\n"
+    "        memset(grown, 0, extra * sizeof(cell));\n"
+    "        index += extra;\n"
+    "    }\n"
+    "    else memset(grown + stack_size, 0, extra * sizeof(cell));\n"
+    "    stack = grown;\n"
+    "    stack_size += extra;\n"
+    "    p = stack + index;\n"
+    "}\n"
+    "\n"
+    "/* Checks that cells lo to hi from the stack pointer are on the stack */\n"
+    "#define CHECK(lo, hi) \\\n"
+    "    if ((p - stack) + (lo) < 0 || (p - stack) + (hi) >= stack_size) reach(lo), reach(hi)\n"
+    "\n"
+    "#define LINE_INPUT %d\n"
+    "#define EOF_VALUE %s\n";
+
+/* Helpers only emitted when the program uses them, so that the output compiles without warnings */
+static const char* c_input_byte =
+    "\n"
+    "static cell input_byte(cell current){\n"
+    "    int c, rest;\n"
+    "    if (LINE_INPUT) fflush(stdout);\n"
+    "    c = rest = getchar();\n"
+    "    if (c == EOF) return EOF_VALUE;\n"
+    "    if (LINE_INPUT) while (rest != '\\n' && rest != EOF) rest = getchar();\n"
+    "    (void)current;\n"
+    "    return (cell)c;\n"
+    "}\n";
+
+static const char* c_input_number =
+    "\n"
+    "static int is_space(int c){\n"
+    "    return c == ' ' || (c >= '\\t' && c <= '\\r');\n"
+    "}\n"
+    "\n"
+    "/* Reads an integer, in decimal or in hex after 0x, consuming the token it starts */\n"
+    "static cell input_number(cell current){\n"
+    "    unsigned long value = 0;\n"
+    "    int c, base = 10, negative = 0;\n"
+    "    if (LINE_INPUT) fflush(stdout);\n"
+    "    do c = getchar(); while (is_space(c));\n"
+    "    if (c == EOF) return EOF_VALUE;\n"
+    "    (void)current;\n"
+    "    if (c == '-' || c == '+'){ negative = (c == '-'); c = getchar(); }\n"
+    "    if (c == '0' && ((c = getchar()) == 'x' || c == 'X')){ base = 16; c = getchar(); }\n"
+    "    for (;; c = getchar()){\n"
+    "        int digit = (c >= '0' && c <= '9') ? c - '0'\n"
+    "                  : (base == 16 && c >= 'a' && c <= 'f') ? c - 'a' + 10\n"
+    "                  : (base == 16 && c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;\n"
+    "        if (digit < 0) break;\n"
+    "        value = value * base + digit;\n"
+    "    }\n"
+    "    while (c != EOF && !is_space(c)) c = getchar();\n"
+    "    return (cell)(negative ? 0 - value : value);\n"
+    "}\n";
+
+static const char* c_print_byte =
+    "\n"
+    "static void print_byte(char c){\n"
+    "    putc(c, stdout);\n"
+    "}\n";
+
+static const char* c_print_number =
+    "\n"
+    "static void print_number(unsigned long value){\n"
+    "    char digits[20];\n"
+    "    int n = 20;\n"
+    "    do digits[--n] = (char)('0' + value % 10); while ((value /= 10) != 0);\n"
+    "    fwrite(digits + n, 1, 20 - n, stdout);\n"
+    "}\n";
+
+static const char* c_main =
+    "\n"
+    "int main(void){\n"
+    "    p = stack = calloc(STACK_SIZE, sizeof(cell));\n"
+    "    if (!stack) return 1;\n";
+
+/* Checks whether any instruction of the program, folded ones included, has the given opcode */
+static int uses_op(const Program* prog, OpCode op){
+    size_t ip;
+    for(ip = 0; ip < prog->len; ++ip){
+        if (prog->code[ip].op == op) return 1;
+    }
+    return 0;
+}
+
+static void indent(FILE* out, int level){
+    fprintf(out, "%*s", level * 4, "");
+}
+
+/* Emits the stack and output left by the prefix folded at compile time, then jumps past it */
+static void emit_prefix(const Program* prog, FILE* out){
+    size_t i, cells = prog->tape_len >> cell_shift;
+    if (prog->entry == 0) return;
+    if (cells > 0){
+        fprintf(out, "    static const cell tape[%zu] = {", cells);
+        for(i = 0; i < cells; ++i){
+            fprintf(out, "%s%lu", i ? ", " : "", get_cell(prog->tape + (i << cell_shift)));
+        }
+        fprintf(out, "};\n    memcpy(stack, tape, sizeof(tape));\n");
+    }
+    if (prog->output_len > 0){
+        fprintf(out, "    static const unsigned char output[%zu] = {", prog->output_len);
+        for(i = 0; i < prog->output_len; ++i){
+            fprintf(out, "%s%u", i ? ", " : "", (unsigned char)prog->output[i]);
+        }
+        fprintf(out, "};\n    for (size_t i = 0; i < sizeof(output); ++i) print_byte((char)output[i]);\n");
+    }
+    fprintf(out, "    p = stack + %ld;\n", prog->entry_pos);
+}
+
+Error emit_c(const Program* prog, FILE* out){
+    int level = 1;
+    size_t ip;
+
+    const char* eof_value =
+        (input_eof == EOF_ZERO) ? "0" :
+        (input_eof == EOF_MINUS_ONE) ? "(cell)-1" : "current";
+
+    fprintf(out, c_prelude, tape_size, stack_growable, 8 << cell_shift, ERR_BOUNDS,
+            input_mode == INPUT_LINE, eof_value);
+    if (uses_op(prog, OP_IN)) fputs(c_input_byte, out);
+    if (uses_op(prog, OP_IN_NUM)) fputs(c_input_number, out);
+    if (uses_op(prog, OP_OUT) || prog->output_len > 0) fputs(c_print_byte, out);
+    if (uses_op(prog, OP_OUT_NUM)) fputs(c_print_number, out);
+    fputs(c_main, out);
+    emit_prefix(prog, out);
+    indent(out, level);
+    fprintf(out, "CHECK(%d, %d);\n", prog->lo, prog->hi);
+    if (prog->entry > 0) fprintf(out, "    goto entry;\n");
+
+    for(ip = 0; ip < prog->len; ++ip){
+        const Instr* ins = &prog->code[ip];
+        if (ip == prog->entry && ip > 0) fprintf(out, "entry:;\n");
+        if (ins->op == OP_CLOSE) level--;
+        indent(out, level);
+        switch(ins->op){
+            case OP_ADD:   fprintf(out, "p[%d] += (cell)%d;\n", ins->offset, ins->arg); break;
+            case OP_MOVE:  fprintf(out, "p += %d;\n", ins->arg); break;
+            case OP_OUT:   fprintf(out, "print_byte((char)p[%d]);\n", ins->offset); break;
+            case OP_IN:    fprintf(out, "p[%d] = input_byte(p[%d]);\n", ins->offset, ins->offset); break;
+            case OP_OUT_NUM: fprintf(out, "print_number(p[%d]);\n", ins->offset); break;
+            case OP_IN_NUM:  fprintf(out, "p[%d] = input_number(p[%d]);\n", ins->offset, ins->offset); break;
+            case OP_CLEAR: fprintf(out, "p[%d] = 0;\n", ins->offset); break;
+            case OP_CHECK: fprintf(out, "CHECK(%d, %d);\n", ins->lo, ins->hi); break;
+            case OP_OPEN:
+                fprintf(out, "while (*p) {\n");
+                level++;
+                indent(out, level);
+                fprintf(out, "CHECK(%d, %d);\n", ins->lo, ins->hi);
+                break;
+            case OP_CLOSE:
+                fprintf(out, "}\n");
+                indent(out, level);
+                fprintf(out, "CHECK(%d, %d);\n", ins->lo, ins->hi);
+                break;
+            case OP_SCAN:
+                fprintf(out, "while (*p) { CHECK(%d, %d); p += %d; }\n", ins->arg, ins->arg, ins->arg);
+                indent(out, level);
+                fprintf(out, "CHECK(%d, %d);\n", ins->lo, ins->hi);
+                break;
+            case OP_ADDS: {
+                int i;
+                fprintf(out, "{ static const cell d[%d] = {", ins->src);
+                for(i = 0; i < ins->src; ++i){
+                    fprintf(out, "%s%lu", i ? ", " : "", get_cell(prog->data + ins->arg + (i << cell_shift)));
+                }
+                fprintf(out, "}; for (int i = 0; i < %d; ++i) p[%d + i] += d[i]; }\n", ins->src, ins->offset);
+                break;
+            }
+            case OP_MULADD:
+                fprintf(out, "if (p[%d]) { CHECK(%d, %d); p[%d] += (cell)((unsigned long)p[%d] * (unsigned long)%d); }\n",
+                        ins->src, ins->offset, ins->offset, ins->offset, ins->src, ins->arg);
+                break;
+        }
+    }
+    if (prog->entry >= prog->len && prog->entry > 0) fprintf(out, "entry:;\n");
+    fprintf(out, "    return 0;\n}\n");
+    return ferror(out) ? ERR_FILE : ERR_OK;
+}
@@ -0,0 +1,86 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "brainduck.h"
+
+/*
+Checks that a basic block reaching cells lo to hi stays within the stack.
+Blocks that only touch the current cell, or that are left to the guard
+pages by relax_bounds_checks, have lo = hi = 0 and are not checked at all.
+*/
+static Error check_block(int lo, int hi){
+    if (check_cell(lo) != ERR_OK || check_cell(hi) != ERR_OK) return ERR_BOUNDS;
+    return ERR_OK;
+}
+
+#define CELL uint8_t
+#define EXECUTE execute_program_8
+#include "execute_cells.h"
+
+#define CELL uint16_t
+#define EXECUTE execute_program_16
+#include "execute_cells.h"
+
+#define CELL uint32_t
+#define EXECUTE execute_program_32
+#include "execute_cells.h"
+
+#define CELL uint8_t
+#define EXECUTE execute_limited_8
+#define LIMITED
+#include "execute_cells.h"
+
+#define CELL uint16_t
+#define EXECUTE execute_limited_16
+#define LIMITED
+#include "execute_cells.h"
+
+#define CELL uint32_t
+#define EXECUTE execute_limited_32
+#define LIMITED
+#include "execute_cells.h"
+
+/*
+Restores the stack and output left by the prefix of a program folded at compile time.
+The cells the prefix kept reach up to the highest one the stack pointer went over.
+*/
+void load_prefix(const Program* prog){
+    memcpy(ctx->stack, prog->tape, prog->tape_len);
+    if (prog->tape_len > 0){
+        touch_cells(ctx->stack, ctx->stack, 0, (long)(prog->tape_len >> cell_shift) - 1);
+        ctx->reached_lo = ctx->stack;
+        ctx->reached_hi = ctx->stack + prog->tape_len - ((size_t)1 << cell_shift);
+    }
+    ctx->stackptr = ctx->stack + (prog->entry_pos << cell_shift);
+    ctx->prefix_steps = prog->entry_steps;
+    print_bytes(prog->output, prog->output_len);
+}
+
+/*
+Runs a compiled program on the stack, with the loop built for the current cell width.
+Only runs with limits or checkpoints use a loop that counts down their budget.
+*/
+Error execute_serial(const Program* prog){
+    if (budget_enabled()){
+        switch(cell_shift){
+            case 1: return execute_limited_16(prog);
+            case 2: return execute_limited_32(prog);
+            default: return execute_limited_8(prog);
+        }
+    }
+    switch(cell_shift){
+        case 1: return execute_program_16(prog);
+        case 2: return execute_program_32(prog);
+        default: return execute_program_8(prog);
+    }
+}
+
+/* Runs a compiled program, splitting it between threads with --parallel */
+Error execute_program(const void* program){
+    if (budget_enabled()){
+        Error err = start_limits();
+        if (err != ERR_OK) return err;
+    }
+    else if (parallel_threads > 1) return execute_parallel(program);
+    return execute_serial(program);
+}
@@ -0,0 +1,142 @@
+/*
+Bytecode interpreter loop for one cell width.
+Included by execute.c once per width, with CELL set to the cell type
+and EXECUTE to the name of the function to define, so that the loop
+itself never branches on the width. With LIMITED defined as well, loop
+back-edges also count down the budget of --max-steps and --timeout-ms,
+and save any checkpoint requested when it runs out, while clears and
+scans count down the steps of the loops they replace.
+The stack pointer is kept in a local and written back to stackptr
+around anything that may move the stack. The lowest and highest cells
+it goes over are kept as well, widened on entry to each block by the
+cells the block moves over, and left in the context along with the
+range of cells the run may have touched.
+*/
+
+static Error EXECUTE(const Program* prog){
+    const Instr* code = prog->code;
+    size_t len = prog->len;
+    size_t ip;
+    Error err = ERR_OK;
+    CELL* ptr;
+    CELL *low, *high; // extremes of the stack pointer
+    char* start = ctx->stack; // to tell whether the stack has moved
+
+#define SYNC_CHECK(expr) \
+    ctx->stackptr = (char*)ptr; \
+    ctx->reached_lo = (char*)low; \
+    ctx->reached_hi = (char*)high; \
+    err = (expr); \
+    ptr = (CELL*)ctx->stackptr; \
+    low = (CELL*)ctx->reached_lo; \
+    high = (CELL*)ctx->reached_hi; \
+    if (err != ERR_OK) goto done
+
+/* Checks the cells a block moves over, from lo to hi, and records them among the extremes */
+#define ENTER_BLOCK(lo, hi) \
+    if (((lo) | (hi)) != 0){ \
+        SYNC_CHECK(check_block(lo, hi)); \
+        if (ptr + (lo) < low) low = ptr + (lo); \
+        if (ptr + (hi) > high) high = ptr + (hi); \
+    }
+
+    ptr = (CELL*)ctx->stackptr;
+    low = ctx->reached_lo ? (CELL*)ctx->reached_lo : ptr;
+    high = ctx->reached_hi ? (CELL*)ctx->reached_hi : ptr;
+    if (ptr < low) low = ptr;
+    if (ptr > high) high = ptr;
+    ENTER_BLOCK(prog->lo, prog->hi);
+    for(ip = prog->entry; ip < len; ++ip){
+        const Instr* ins = &code[ip];
+        COUNT(steps, 1);
+        switch(ins->op){
+            case OP_ADD: ptr[ins->offset] += (CELL)ins->arg; break;
+            case OP_MOVE:
+                ptr += ins->arg;
+                if (ptr < low) low = ptr;
+                if (ptr > high) high = ptr;
+                break;
+            case OP_OUT: // straight into the output buffer while that does not need flushing
+                if (ctx->output_len < OUTPUT_SIZE - 1 && !output_unbuffered) ctx->output[ctx->output_len++] = (char)ptr[ins->offset];
+                else print_byte((char)ptr[ins->offset]);
+                break;
+            case OP_IN: // and out of the input buffer or mapping while there is some left
+                if (input_mode == INPUT_STREAM && ctx->input_pos < ctx->input_len){
+                    ptr[ins->offset] = (CELL)(unsigned char)ctx->input_data[ctx->input_pos++];
+                }
+                else ptr[ins->offset] = (CELL)input_byte(ptr[ins->offset]);
+                break;
+            case OP_OUT_NUM: print_number(ptr[ins->offset]); break;
+            case OP_IN_NUM: ptr[ins->offset] = (CELL)input_number((long)ptr[ins->offset]); break;
+            case OP_OPEN:
+                if (*ptr == 0) ip = ins->arg;
+                ENTER_BLOCK(code[ip].lo, code[ip].hi);
+                break;
+            case OP_CLOSE:
+                if (*ptr != 0){
+#ifdef LIMITED
+                    ctx->budget -= (long)ins->steps;
+                    if (ctx->budget <= 0){
+                        ctx->stackptr = (char*)ptr;
+                        if (refill_budget() != ERR_OK){
+                            err = ERR_LIMIT;
+                            goto done;
+                        }
+                        if (checkpoint_requested) save_checkpoint((size_t)ins->arg);
+                    }
+#endif
+                    ip = ins->arg;
+                    COUNT(iterations, 1);
+                }
+                ENTER_BLOCK(code[ip].lo, code[ip].hi);
+                break;
+            case OP_SCAN: // the block after it is checked even if the scan does not run
+                if (*ptr != 0){
+#ifdef LIMITED
+                    SYNC_CHECK(scan_stack(ins->arg, ins->steps));
+#else
+                    SYNC_CHECK(scan_stack(ins->arg, 0));
+#endif
+                    if (ptr < low) low = ptr;
+                    if (ptr > high) high = ptr;
+                }
+                ENTER_BLOCK(ins->lo, ins->hi);
+                break;
+            case OP_CLEAR:
+#ifdef LIMITED
+                if (ins->steps > 0 && ptr[ins->offset] != 0){
+                    CELL times = (ins->arg < 0) ? ptr[ins->offset] : (CELL)-ptr[ins->offset]; // round the loop
+                    SYNC_CHECK(charge_steps((unsigned long long)(times - 1) * ins->steps));
+                }
+#endif
+                ptr[ins->offset] = 0;
+                break;
+            case OP_CHECK:
+                ENTER_BLOCK(ins->lo, ins->hi);
+                break;
+            case OP_ADDS: add_cells((char*)(ptr + ins->offset), prog->data + ins->arg, ins->src); break;
+            case OP_MULADD:
+                if (ptr[ins->src] == 0) break;
+                SYNC_CHECK(check_cell(ins->offset));
+                if (ptr + ins->offset < low) low = ptr + ins->offset;
+                if (ptr + ins->offset > high) high = ptr + ins->offset;
+                ptr[ins->offset] += (CELL)((unsigned long)ptr[ins->src] * (unsigned long)ins->arg);
+                break;
+        }
+    }
+    ctx->stackptr = (char*)ptr;
+    err = check_cell(0); // with guard pages, a final move may have left the stack unchecked
+
+done:
+    ctx->reached_lo = (char*)low;
+    ctx->reached_hi = (char*)high;
+    if (ctx->stack == start) touch_cells((char*)low, (char*)high, prog->reach_lo, prog->reach_hi);
+    return err;
+
+#undef SYNC_CHECK
+#undef ENTER_BLOCK
+}
+
+#undef CELL
+#undef EXECUTE
+#undef LIMITED
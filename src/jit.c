@@ -0,0 +1,415 @@
+#include "brainduck.h"
+
+/*
+Native code generation for x86-64.
+
+The generated function takes a pointer to a JitEnv in rdi and keeps
+    rbx  the environment
+    r12  the stack pointer
+    r13  the start of the stack
+    r14  the end of the stack
+It only refers to memory and to the I/O functions through rbx,
+so the code does not depend on where it is loaded.
+Cells found outside of the stack are handed to check_cell, which either
+grows the stack, after which the registers are reloaded, or fails the run.
+When limits or checkpoints are set, loop back-edges also count down the
+budget kept in the environment, and call refill_budget once it runs out.
+Code compiled for --stats keeps the extremes of the stack pointer in the
+environment as well, widening them on entry to each block.
+On other platforms, and for cells wider than 8 bits, jit_compile fails
+and the bytecode interpreter is used instead.
+*/
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <string.h>
+#include <sys/mman.h>
+
+#define JIT_MAX_INSTR 192 // longest machine code emitted for any instruction
+#define JIT_OVERHEAD  128 // prologue, epilogue and error exits
+
+typedef struct jit_env {
+    char* ptr;              // +0  stack pointer, updated on return
+    char* start;            // +8
+    char* end;              // +16
+    void (*print)(char);    // +24
+    long (*input)(long);    // +32
+    int (*reach)(struct jit_env*, long); // +40 called when a cell falls outside of the stack
+    int (*scan)(struct jit_env*, long, unsigned); // +48 runs a scan loop with the given stride, charging the given steps
+    long budget;                         // +56 steps left before limit is called
+    int (*limit)(struct jit_env*, int);  // +64 called with the loop's OP_OPEN, or -1 outside of a back-edge, when the budget runs out
+    void (*print_number)(unsigned long); // +72
+    long (*input_number)(long);          // +80
+    char* low;                           // +88 lowest cell the stack pointer has been on
+    char* high;                          // +96 highest cell the stack pointer has been on
+} JitEnv;
+
+typedef struct jit_buffer {
+    unsigned char* code;
+    size_t len;
+} JitBuffer;
+
+static void put(JitBuffer* b, const char* bytes, size_t n){
+    memcpy(b->code + b->len, bytes, n);
+    b->len += n;
+}
+
+static void put8(JitBuffer* b, int v){
+    b->code[b->len++] = (unsigned char)v;
+}
+
+static void put32(JitBuffer* b, int v){
+    memcpy(b->code + b->len, &v, 4);
+    b->len += 4;
+}
+
+/* Emits a rel32 jump instruction to target */
+static void put_jump(JitBuffer* b, const char* op, size_t n, size_t target){
+    put(b, op, n);
+    put32(b, (int)((long)target - (long)(b->len + 4)));
+}
+
+/* Patches the rel32 operand ending at 'at' so that it jumps to target */
+static void patch_jump(JitBuffer* b, size_t at, size_t target){
+    int rel = (int)((long)target - (long)at);
+    memcpy(b->code + at - 4, &rel, 4);
+}
+
+/* Emits a check that the cell at offset from the stack pointer is on the stack */
+static void put_cell_check(JitBuffer* b, int offset, size_t reach){
+    if (offset == 0) return; // the stack pointer itself is always valid
+    put(b, "\x49\x8D\x84\x24", 4); put32(b, offset); // lea rax, [r12+offset]
+    if (offset < 0) put(b, "\x4C\x39\xE8\x73\x0A", 5); // cmp rax, r13; jae ok
+    else put(b, "\x4C\x39\xF0\x72\x0A", 5);            // cmp rax, r14; jb ok
+    put(b, "\xBE", 1); put32(b, offset);                 // mov esi, offset
+    put_jump(b, "\xE8", 1, reach);                       // call reach
+}
+
+/* Emits a check that cells lo to hi from the stack pointer are on the stack */
+static void put_block_check(JitBuffer* b, int lo, int hi, size_t reach){
+    put_cell_check(b, lo, reach);
+    put_cell_check(b, hi, reach);
+}
+
+/* Emits code widening the extremes of the stack pointer to cells lo to hi from it */
+static void put_reach(JitBuffer* b, int lo, int hi){
+    put(b, "\x49\x8D\x84\x24", 4); put32(b, lo); // lea rax, [r12+lo]
+    put(b, "\x48\x3B\x43\x58\x73\x04", 6);    // cmp rax, [rbx+88]; jae over
+    put(b, "\x48\x89\x43\x58", 4);              // mov [rbx+88], rax
+    put(b, "\x49\x8D\x84\x24", 4); put32(b, hi); // lea rax, [r12+hi]
+    put(b, "\x48\x3B\x43\x60\x76\x04", 6);    // cmp rax, [rbx+96]; jbe over
+    put(b, "\x48\x89\x43\x60", 4);              // mov [rbx+96], rax
+}
+
+/*
+Emits the entry to a block moving over cells lo to hi from the stack pointer:
+their bounds check and, if tracked, the widening of the extremes of the stack pointer.
+*/
+static void put_block_entry(JitBuffer* b, int lo, int hi, size_t reach, int tracked){
+    put_block_check(b, lo, hi, reach);
+    if (tracked && (lo | hi) != 0) put_reach(b, lo, hi);
+}
+
+/* Emits OP_ADDS as one SSE2 add per 16 cells, reading the pattern from a copy placed within the code */
+static void put_adds(JitBuffer* b, int offset, const char* deltas, int count){
+    size_t data;
+    int i;
+    put_jump(b, "\xE9", 1, 0); // jmp over the pattern
+    data = b->len;
+    put(b, deltas, (size_t)count);
+    patch_jump(b, data, b->len);
+    for(i = 0; i + 16 <= count; i += 16){
+        put(b, "\xF3\x41\x0F\x6F\x84\x24", 6); put32(b, offset + i); // movdqu xmm0, [r12+offset+i]
+        put(b, "\xF3\x0F\x6F\x0D", 4);                               // movdqu xmm1, [rip+pattern+i]
+        put32(b, (int)((long)(data + i) - (long)(b->len + 4)));
+        put(b, "\x66\x0F\xFC\xC1", 4);                               // paddb xmm0, xmm1
+        put(b, "\xF3\x41\x0F\x7F\x84\x24", 6); put32(b, offset + i); // movdqu [r12+offset+i], xmm0
+    }
+    for(; i < count; ++i){
+        if (deltas[i] == 0) continue;
+        put(b, "\x41\x80\x84\x24", 4); put32(b, offset + i); // add byte [r12+offset+i], delta
+        put8(b, deltas[i]);
+    }
+}
+
+/* Size of the machine code emitted for an instruction, at most */
+static size_t jit_size(const Instr* ins){
+    if (ins->op == OP_ADDS) return JIT_MAX_INSTR + (size_t)ins->src * 10;
+    return JIT_MAX_INSTR;
+}
+
+int jit_compile(const Program* prog, JitCode* jit){
+    size_t cap = JIT_OVERHEAD;
+    size_t* labels = NULL; // OP_OPEN: address of its block, OP_CLOSE: unused
+    size_t reach, limit, leave, ip;
+    int limited = budget_enabled();
+    int tracked = stats_enabled; // record where the stack pointer goes, for --stats
+    JitBuffer b = {0};
+
+    if (cell_shift != 0) return 0;
+    for(ip = 0; ip < prog->len; ++ip) cap += jit_size(&prog->code[ip]);
+    b.code = mmap(NULL, cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (b.code == MAP_FAILED) return 0;
+    labels = malloc((prog->len > 0 ? prog->len : 1) * sizeof(size_t));
+    if (!labels){
+        munmap(b.code, cap);
+        return 0;
+    }
+
+    /* Prologue, then skip over the shared exits */
+    put(&b, "\x55\x53\x41\x54\x41\x55\x41\x56", 8); // push rbp, rbx, r12, r13, r14
+    put(&b, "\x48\x89\xFB", 3);                     // mov rbx, rdi
+    put(&b, "\x4C\x8B\x23", 3);                     // mov r12, [rbx]
+    put(&b, "\x4C\x8B\x6B\x08", 4);                 // mov r13, [rbx+8]
+    put(&b, "\x4C\x8B\x73\x10", 4);                 // mov r14, [rbx+16]
+    put(&b, "\xE9", 1); put32(&b, 0);               // jmp body
+    size_t skip = b.len;
+
+    leave = b.len;
+    put(&b, "\x4C\x89\x23", 3);                       // mov [rbx], r12
+    put(&b, "\x41\x5E\x41\x5D\x41\x5C\x5B\x5D\xC3", 9); // pop r14, r13, r12, rbx, rbp; ret
+
+    /* Called with the offset of a missing cell in esi */
+    reach = b.len;
+    put(&b, "\x4C\x89\x23", 3);        // mov [rbx], r12
+    put(&b, "\x48\x89\xDF", 3);        // mov rdi, rbx
+    put(&b, "\x48\x63\xF6", 3);        // movsxd rsi, esi
+    put(&b, "\x48\x83\xEC\x08", 4);    // sub rsp, 8
+    put(&b, "\xFF\x53\x28", 3);        // call [rbx+40]
+    put(&b, "\x48\x83\xC4\x08", 4);    // add rsp, 8
+    put(&b, "\x4C\x8B\x23", 3);        // mov r12, [rbx]
+    put(&b, "\x4C\x8B\x6B\x08", 4);    // mov r13, [rbx+8]
+    put(&b, "\x4C\x8B\x73\x10", 4);    // mov r14, [rbx+16]
+    put(&b, "\x85\xC0\x75\x01\xC3", 5); // test eax, eax; jnz fail; ret
+    put(&b, "\x48\x83\xC4\x08", 4);    // fail: add rsp, 8
+    put_jump(&b, "\xE9", 1, leave);     // jmp leave
+
+    /* Called when the budget runs out, with the instruction opening the loop in esi */
+    limit = b.len;
+    put(&b, "\x4C\x89\x23", 3);        // mov [rbx], r12
+    put(&b, "\x48\x89\xDF", 3);        // mov rdi, rbx
+    put(&b, "\x48\x83\xEC\x08", 4);    // sub rsp, 8
+    put(&b, "\xFF\x53\x40", 3);        // call [rbx+64]
+    put(&b, "\x48\x83\xC4\x08", 4);    // add rsp, 8
+    put(&b, "\x85\xC0\x75\x01\xC3", 5); // test eax, eax; jnz fail; ret
+    put(&b, "\x48\x83\xC4\x08", 4);    // fail: add rsp, 8
+    put_jump(&b, "\xE9", 1, leave);     // jmp leave
+    patch_jump(&b, skip, b.len);
+
+    put_block_entry(&b, prog->lo, prog->hi, reach, tracked);
+    put_jump(&b, "\xE9", 1, 0); // jmp entry, patched below
+    size_t entry = b.len;
+    for(ip = 0; ip < prog->len; ++ip){
+        const Instr* ins = &prog->code[ip];
+        if (ip == prog->entry) patch_jump(&b, entry, b.len);
+        switch(ins->op){
+            case OP_ADD:
+                put(&b, "\x41\x80\x84\x24", 4); put32(&b, ins->offset); // add byte [r12+offset], arg
+                put8(&b, ins->arg);
+                break;
+            case OP_MOVE:
+                put(&b, "\x49\x81\xC4", 3); put32(&b, ins->arg); // add r12, arg
+                break;
+            case OP_OUT:
+                put(&b, "\x41\x0F\xB6\xBC\x24", 5); put32(&b, ins->offset); // movzx edi, byte [r12+offset]
+                put(&b, "\xFF\x53\x18", 3);                                 // call [rbx+24]
+                break;
+            case OP_IN:
+                put(&b, "\x41\x0F\xB6\xBC\x24", 5); put32(&b, ins->offset); // movzx edi, byte [r12+offset]
+                put(&b, "\xFF\x53\x20", 3);                                 // call [rbx+32]
+                put(&b, "\x41\x88\x84\x24", 4); put32(&b, ins->offset);    // mov [r12+offset], al
+                break;
+            case OP_OUT_NUM:
+                put(&b, "\x41\x0F\xB6\xBC\x24", 5); put32(&b, ins->offset); // movzx edi, byte [r12+offset]
+                put(&b, "\xFF\x53\x48", 3);                                 // call [rbx+72]
+                break;
+            case OP_IN_NUM:
+                put(&b, "\x41\x0F\xB6\xBC\x24", 5); put32(&b, ins->offset); // movzx edi, byte [r12+offset]
+                put(&b, "\xFF\x53\x50", 3);                                 // call [rbx+80]
+                put(&b, "\x41\x88\x84\x24", 4); put32(&b, ins->offset);    // mov [r12+offset], al
+                break;
+            case OP_OPEN:
+                put(&b, "\x41\x80\x3C\x24\x00", 5);  // cmp byte [r12], 0
+                put_jump(&b, "\x0F\x84", 2, 0);      // je past the matching bracket, patched below
+                labels[ip] = b.len;
+                put_block_entry(&b, ins->lo, ins->hi, reach, tracked);
+                break;
+            case OP_CLOSE:
+                put(&b, "\x41\x80\x3C\x24\x00", 5);            // cmp byte [r12], 0
+                if (limited){
+                    put_jump(&b, "\x0F\x84", 2, 0);               // je out of the loop
+                    size_t out = b.len;
+                    put(&b, "\x48\x81\x6B\x38", 4); put32(&b, (int)ins->steps); // sub qword [rbx+56], steps
+                    put_jump(&b, "\x0F\x8F", 2, labels[ins->arg]); // jg into the loop body
+                    put(&b, "\xBE", 1); put32(&b, ins->arg);       // mov esi, open
+                    put_jump(&b, "\xE8", 1, limit);                 // call limit
+                    put_jump(&b, "\xE9", 1, labels[ins->arg]);      // jmp into the loop body
+                    patch_jump(&b, out, b.len);
+                }
+                else put_jump(&b, "\x0F\x85", 2, labels[ins->arg]); // jne into the loop body
+                patch_jump(&b, labels[ins->arg], b.len);
+                put_block_entry(&b, ins->lo, ins->hi, reach, tracked);
+                break;
+            case OP_SCAN: {
+                put(&b, "\x41\x80\x3C\x24\x00", 5);      // cmp byte [r12], 0
+                put_jump(&b, "\x0F\x84", 2, 0);          // je check, past the scan but not the block check
+                size_t done = b.len;
+                put(&b, "\x4C\x89\x23", 3);               // mov [rbx], r12
+                put(&b, "\x48\x89\xDF", 3);               // mov rdi, rbx
+                put(&b, "\x48\xC7\xC6", 3); put32(&b, ins->arg); // mov rsi, stride
+                put(&b, "\xBA", 1); put32(&b, limited ? (int)ins->steps : 0); // mov edx, steps
+                put(&b, "\xFF\x53\x30", 3);               // call [rbx+48]
+                put(&b, "\x4C\x8B\x23", 3);               // mov r12, [rbx]
+                put(&b, "\x4C\x8B\x6B\x08", 4);           // mov r13, [rbx+8]
+                put(&b, "\x4C\x8B\x73\x10", 4);           // mov r14, [rbx+16]
+                put(&b, "\x85\xC0", 2);                   // test eax, eax
+                put_jump(&b, "\x0F\x85", 2, leave);      // jnz leave
+                patch_jump(&b, done, b.len);
+                put_block_entry(&b, ins->lo, ins->hi, reach, tracked);
+                break;
+            }
+            case OP_CLEAR:
+                if (limited && ins->steps > 0){ // charge the loop replaced, round it once per time less than the cell
+                    put(&b, "\x41\x0F\xB6\x84\x24", 5); put32(&b, ins->offset); // movzx eax, byte [r12+offset]
+                    if (ins->arg > 0) put(&b, "\xF6\xD8\x0F\xB6\xC0", 5);       // neg al; movzx eax, al
+                    put(&b, "\x85\xC0", 2);                                         // test eax, eax
+                    put_jump(&b, "\x0F\x84", 2, 0);                                 // je clear
+                    size_t clear = b.len;
+                    put(&b, "\xFF\xC8", 2);                                         // dec eax
+                    put(&b, "\x48\x69\xC0", 3); put32(&b, (int)ins->steps);        // imul rax, rax, steps
+                    put(&b, "\x48\x29\x43\x38", 4);                               // sub [rbx+56], rax
+                    put_jump(&b, "\x0F\x8F", 2, 0);                                 // jg clear
+                    size_t left = b.len;
+                    put(&b, "\xBE", 1); put32(&b, -1);                               // mov esi, -1
+                    put_jump(&b, "\xE8", 1, limit);                                   // call limit
+                    patch_jump(&b, clear, b.len);
+                    patch_jump(&b, left, b.len);
+                }
+                put(&b, "\x41\xC6\x84\x24", 4); put32(&b, ins->offset); // mov byte [r12+offset], 0
+                put8(&b, 0);
+                break;
+            case OP_CHECK:
+                put_block_entry(&b, ins->lo, ins->hi, reach, tracked);
+                break;
+            case OP_ADDS:
+                put_adds(&b, ins->offset, prog->data + ins->arg, ins->src);
+                break;
+            case OP_MULADD: {
+                put(&b, "\x41\x80\xBC\x24", 4); put32(&b, ins->src); // cmp byte [r12+src], 0
+                put8(&b, 0);
+                put_jump(&b, "\x0F\x84", 2, 0);                         // je skip
+                size_t zero = b.len;
+                if (!stack_guarded || ins->offset < -stack_guard_below() || ins->offset > STACK_GUARD){
+                    put_cell_check(&b, ins->offset, reach); // otherwise left to the guard pages
+                }
+                put(&b, "\x41\x0F\xB6\x84\x24", 5); put32(&b, ins->src); // movzx eax, byte [r12+src]
+                put(&b, "\x69\xC0", 2); put32(&b, ins->arg);             // imul eax, eax, arg
+                put(&b, "\x41\x00\x84\x24", 4); put32(&b, ins->offset); // add [r12+offset], al
+                if (tracked) put_reach(&b, ins->offset, ins->offset);
+                patch_jump(&b, zero, b.len);
+                break;
+            }
+        }
+    }
+    if (prog->entry >= prog->len) patch_jump(&b, entry, b.len);
+    put(&b, "\x31\xC0", 2);             // xor eax, eax
+    put_jump(&b, "\xE9", 1, leave);     // jmp leave
+    free(labels);
+
+    if (mprotect(b.code, cap, PROT_READ | PROT_EXEC) != 0){
+        munmap(b.code, cap);
+        return 0;
+    }
+    jit->code = b.code;
+    jit->size = cap;
+    return 1;
+}
+
+/* Runs a scan loop, which may grow the stack, charging the budget for it */
+static int jit_scan(JitEnv* env, long stride, unsigned steps){
+    Error err;
+    ctx->stackptr = env->ptr;
+    ctx->budget = env->budget;
+    ctx->reached_lo = env->low;
+    ctx->reached_hi = env->high;
+    err = scan_stack(stride, steps);
+    env->budget = ctx->budget;
+    env->ptr = ctx->stackptr;
+    env->low = (ctx->stackptr < ctx->reached_lo) ? ctx->stackptr : ctx->reached_lo;
+    env->high = (ctx->stackptr > ctx->reached_hi) ? ctx->stackptr : ctx->reached_hi;
+    env->start = ctx->stack;
+    env->end = ctx->stack + ctx->stack_size;
+    return err;
+}
+
+/*
+Checks the limits once the budget has run out, failing with ERR_LIMIT if one has been reached,
+and saves any checkpoint requested in the loop opened by instruction open, if any.
+*/
+static int jit_limit(JitEnv* env, int open){
+    Error err;
+    ctx->budget = env->budget;
+    ctx->stackptr = env->ptr;
+    err = refill_budget();
+    if (err == ERR_OK && checkpoint_requested && open >= 0) save_checkpoint((size_t)open);
+    env->budget = ctx->budget;
+    return err;
+}
+
+/* Makes the cell at offset from the stack pointer exist, or fails with ERR_BOUNDS */
+static int jit_reach(JitEnv* env, long offset){
+    Error err;
+    ctx->stackptr = env->ptr;
+    ctx->reached_lo = env->low;
+    ctx->reached_hi = env->high;
+    err = check_cell(offset);
+    env->ptr = ctx->stackptr;
+    env->low = ctx->reached_lo;
+    env->high = ctx->reached_hi;
+    env->start = ctx->stack;
+    env->end = ctx->stack + ctx->stack_size;
+    return err;
+}
+
+Error jit_run(const void* code){
+    const JitCode* jit = code;
+    char* low = (ctx->reached_lo && ctx->reached_lo < ctx->stackptr) ? ctx->reached_lo : ctx->stackptr;
+    char* high = (ctx->reached_hi && ctx->reached_hi > ctx->stackptr) ? ctx->reached_hi : ctx->stackptr;
+    JitEnv env = { ctx->stackptr, ctx->stack, ctx->stack + ctx->stack_size, print_byte, input_byte,
+                   jit_reach, jit_scan, 0, jit_limit, print_number, input_number, low, high };
+    int (*fn)(JitEnv*) = (int (*)(JitEnv*))jit->code;
+    Error err;
+    touch_stack(); // native code does not keep track of the cells it writes
+    if ((err = start_limits()) != ERR_OK) return err;
+    env.budget = ctx->budget;
+    err = (Error)fn(&env);
+    ctx->stackptr = env.ptr;
+    ctx->reached_lo = env.low;
+    ctx->reached_hi = env.high;
+    if (err == ERR_OK) err = check_cell(0); // with guard pages, a final move may have left the stack unchecked
+    return err;
+}
+
+void jit_free(JitCode* jit){
+    if (jit->code) munmap(jit->code, jit->size);
+    jit->code = NULL;
+    jit->size = 0;
+}
+
+#else
+
+int jit_compile(const Program* prog, JitCode* jit){
+    (void)prog;
+    (void)jit;
+    return 0;
+}
+
+Error jit_run(const void* code){
+    (void)code;
+    return ERR_UNKNOWN;
+}
+
+void jit_free(JitCode* jit){
+    (void)jit;
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef LIBBRAINDUCK_H
+#define LIBBRAINDUCK_H
+
+#include <stddef.h>
+
+/*
+Embeddable brainduck interpreter.
+
+A bd_context holds its own stack and I/O buffers, so any number of them
+can run at once, each on one thread at a time. Input and output go
+through callbacks, which default to stdin and stdout. Settings such as
+the cell width and the stack size are the process-wide defaults.
+
+    bd_context* bd = bd_create(&io);
+    if (bd_compile(bd, src, size) == BD_OK){
+        bd_run(bd);   // first request
+        bd_run(bd);   // next request, on a zeroed stack
+    }
+    bd_destroy(bd);
+
+A bd_program is a compiled script that is never modified once created,
+so a single one can be shared by any number of contexts on any threads:
+
+    bd_program* prog = bd_program_create(src, size, &err);
+    bd_run_program(bd, prog);   // on each worker's own context
+    bd_program_destroy(prog);   // once no context is running it
+*/
+
+/* Marks the functions exported by the library, which is built with every other symbol hidden */
+#if defined(__GNUC__)
+#define BD_API __attribute__((visibility("default")))
+#else
+#define BD_API
+#endif
+
+typedef struct bd_context bd_context;
+typedef struct bd_program bd_program;
+
+/* Error codes, the same as the exit codes of the command line tool */
+enum bd_error {
+    BD_OK = 0,
+    BD_ERR_UNKNOWN_CHAR,
+    BD_ERR_MATCHING_BRACKET,
+    BD_ERR_BOUNDS,
+    BD_ERR_FILE,
+    BD_ERR_UNKNOWN,
+    BD_ERR_LIMIT,
+    BD_ERR_MACRO
+};
+
+/* I/O callbacks, each given its own user pointer */
+typedef struct bd_io {
+    long (*read)(void* user, char* buf, size_t size); // up to size bytes of input, 0 at its end, NULL for stdin
+    void* read_user;
+    long (*write)(void* user, const char* buf, size_t size); // all of buf, or -1 on failure, NULL for stdout
+    void* write_user;
+} bd_io;
+
+BD_API bd_program* bd_program_create(const char* src, size_t size, int* err);
+BD_API void bd_program_destroy(bd_program* program);
+
+BD_API void bd_set_limits(unsigned long long steps, long ms);
+
+BD_API bd_context* bd_create(const bd_io* io);
+BD_API int bd_compile(bd_context* bd, const char* src, size_t size);
+BD_API int bd_run(bd_context* bd);
+BD_API int bd_run_program(bd_context* bd, const bd_program* program);
+BD_API void bd_reset(bd_context* bd);
+BD_API void bd_destroy(bd_context* bd);
+BD_API const char* bd_strerror(int err);
+
+#endif /* LIBBRAINDUCK_H */
@@ -0,0 +1,143 @@
+#include <unistd.h>
+
+#include "brainduck.h"
+#include "libbrainduck.h"
+
+/*
+Library interface over the interpreter: a bd_context is an execution
+context, and a bd_program a compiled script that is only ever read once
+built, so one program can be run by many contexts at once. Each call
+makes the context current on the calling thread for its duration only,
+so contexts can be used from any thread, one at a time.
+*/
+
+typedef char bd_errors_match[(BD_ERR_BOUNDS == (int)ERR_BOUNDS && BD_ERR_MACRO == (int)ERR_MACRO) ? 1 : -1];
+
+struct bd_program {
+    Program prog;
+};
+
+struct bd_context {
+    Context* context;
+    bd_program* own; // program compiled by bd_compile, if any
+    int dirty; // the stack has been used since it was last cleared
+};
+
+/* Compiles a script, storing the error code in err if it fails */
+bd_program* bd_program_create(const char* src, size_t size, int* err){
+    bd_program* program = calloc(1, sizeof(bd_program));
+    size_t* jumps = NULL;
+    size_t where = 0;
+    Expansion exp = {0};
+    Error e = program ? expand_macros(src, size, &exp) : ERR_UNKNOWN;
+
+    if (e == ERR_OK){
+        jumps = malloc((exp.size > 0 ? exp.size : 1) * sizeof(size_t));
+        e = jumps ? check_matching_brackets(exp.src, exp.size, jumps, &where, NULL) : ERR_UNKNOWN;
+        if (e == ERR_OK) e = compile_program(exp.src, exp.size, jumps, &program->prog, NULL);
+        free_expansion(&exp);
+    }
+    free(jumps);
+    if (err) *err = e;
+    if (e != ERR_OK){
+        free(program);
+        return NULL;
+    }
+    optimize_program(&program->prog);
+    return program;
+}
+
+void bd_program_destroy(bd_program* program){
+    if (!program) return;
+    free_program(&program->prog);
+    free(program);
+}
+
+/*
+Limits every later run, in any context, to at most steps commands
+run in loops and ms milliseconds, either being 0 for no limit.
+Runs that go over fail with BD_ERR_LIMIT, as do runs of programs whose
+start, run once when they were created, already took more steps.
+*/
+void bd_set_limits(unsigned long long steps, long ms){
+    max_steps = steps;
+    timeout_ms = ms;
+}
+
+bd_context* bd_create(const bd_io* io){
+    Context* current = ctx;
+    bd_context* bd = calloc(1, sizeof(bd_context));
+    if (!bd) return NULL;
+    bd->context = create_context(
+        (io && io->read) ? io->read : read_fd, (io && io->read) ? io->read_user : (void*)(long)STDIN_FILENO,
+        (io && io->write) ? io->write : write_file, (io && io->write) ? io->write_user : (void*)stdout);
+    ctx = current;
+    if (!bd->context){
+        free(bd);
+        return NULL;
+    }
+    return bd;
+}
+
+/* Compiles a script into the context, replacing any previous one */
+int bd_compile(bd_context* bd, const char* src, size_t size){
+    int err;
+    bd_program_destroy(bd->own);
+    bd->own = bd_program_create(src, size, &err);
+    return err;
+}
+
+/* Runs the script compiled into the context once, from a zeroed stack */
+int bd_run(bd_context* bd){
+    if (!bd->own) return BD_ERR_UNKNOWN;
+    return bd_run_program(bd, bd->own);
+}
+
+/* Runs a program once on the context, from a zeroed stack */
+int bd_run_program(bd_context* bd, const bd_program* program){
+    Context* current = ctx;
+    Error err;
+    if (bd->dirty) bd_reset(bd);
+    ctx = bd->context;
+    bd->dirty = 1;
+    load_prefix(&program->prog);
+    err = run_guarded(execute_program, &program->prog);
+    flush_output();
+    ctx = current;
+    return err;
+}
+
+/*
+Zeroes the stack and drops any input left over from the last run.
+Only the cells the last runs may have written are cleared, so resetting
+after a short run costs little even on a large stack.
+*/
+void bd_reset(bd_context* bd){
+    Context* current = ctx;
+    ctx = bd->context;
+    clear_stack();
+    ctx->input_pos = ctx->input_len = 0;
+    ctx->output_len = 0;
+    ctx = current;
+    bd->dirty = 0;
+}
+
+void bd_destroy(bd_context* bd){
+    if (!bd) return;
+    bd_program_destroy(bd->own);
+    destroy_context(bd->context);
+    free(bd);
+}
+
+const char* bd_strerror(int err){
+    switch(err){
+        case BD_OK: return "no error";
+        case BD_ERR_UNKNOWN_CHAR: return "unknown character";
+        case BD_ERR_MATCHING_BRACKET: return "missing matching bracket";
+        case BD_ERR_BOUNDS: return "stack pointer out of bounds";
+        case BD_ERR_FILE: return "could not open file";
+        case BD_ERR_LIMIT: return "execution limit exceeded";
+        case BD_ERR_MACRO: return "undefined or malformed macro";
+        default: return "unknown error";
+    }
+}
@@ -0,0 +1,89 @@
+#include <limits.h>
+#include <time.h>
+
+#include "brainduck.h"
+
+/*
+Limits on how long a script may run, for --max-steps and --timeout-ms.
+The engines only look at them on loop back-edges: each one takes the
+commands of the loop, as written in the script, off the budget of the
+context, so that a run takes the same steps on every engine, and once
+that runs out refill_budget works out whether a limit has been reached.
+Loops collapsed into single instructions, or run at compile time,
+are charged the steps of every time round they replace.
+Code outside of loops runs at most once, so it needs no checking.
+The budget is handed out in slices, so that the clock is only read
+every LIMIT_SLICE steps or so. Runs taking checkpoints keep a
+budget as well, since that is when the engines look for a request.
+*/
+
+#define LIMIT_SLICE (1L << 20) // steps run between two looks at the clock
+
+unsigned long long max_steps = 0; // most steps a run may take in loops, or 0 for no limit
+long timeout_ms = 0; // most milliseconds a run may take, or 0 for no limit
+
+static long long now_ns(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+/* Checks whether a run is limited at all */
+static int limits_enabled(){
+    return max_steps > 0 || timeout_ms > 0;
+}
+
+/* Checks whether the engines have to keep a budget, to enforce limits or to take checkpoints */
+int budget_enabled(){
+    return limits_enabled() || checkpoint_file != NULL;
+}
+
+/* Hands the current context the next slice of its budget */
+static void grant(){
+    long slice = LIMIT_SLICE;
+    if (!budget_enabled()) slice = LONG_MAX;
+    else if (max_steps > 0 && ctx->steps_left < (unsigned long long)slice) slice = (long)ctx->steps_left;
+    ctx->budget = ctx->granted = (slice > 0) ? slice : 1;
+}
+
+/*
+Starts counting the limits of a run on the current context, from the
+steps its folded prefix took. Returns ERR_LIMIT if those are too many already.
+*/
+Error start_limits(){
+    ctx->steps_left = max_steps;
+    ctx->deadline = (timeout_ms > 0) ? now_ns() + (long long)timeout_ms * 1000000LL : 0;
+    if (max_steps > 0){
+        if (ctx->prefix_steps > max_steps) return ERR_LIMIT;
+        ctx->steps_left -= ctx->prefix_steps;
+    }
+    grant();
+    return ERR_OK;
+}
+
+/*
+Called once the budget of the current context has run out.
+Returns ERR_LIMIT if the run has taken more steps or time than allowed,
+or hands out a new slice of the budget and returns ERR_OK.
+*/
+Error refill_budget(){
+    unsigned long long used = (unsigned long long)(ctx->granted - ctx->budget);
+    if (max_steps > 0){
+        if (used > ctx->steps_left) return ERR_LIMIT;
+        ctx->steps_left -= used;
+    }
+    if (timeout_ms > 0 && now_ns() >= ctx->deadline) return ERR_LIMIT;
+    grant();
+    return ERR_OK;
+}
+
+/*
+Takes the steps of a loop run all at once, by an instruction replacing it,
+off the budget of the current context, failing like refill_budget once
+that runs out.
+*/
+Error charge_steps(unsigned long long steps){
+    if (steps > LONG_MAX / 4) steps = LONG_MAX / 4; // more than any budget, without overflowing it
+    ctx->budget -= (long)steps;
+    return (ctx->budget <= 0) ? refill_budget() : ERR_OK;
+}
@@ -0,0 +1,275 @@
+#include <string.h>
+
+#include "brainduck.h"
+
+/*
+Macros and imports, expanded into plain code before the script is checked
+and compiled, so every later stage sees the script fully inlined:
+
+    !name{code}   defines a macro, its name being made of letters only
+    !name         is replaced by the code of the macro
+    @script       defines the macros of script.bf, in the current directory
+
+The code of a macro is expanded as it is defined, so it may call the
+macros defined before it but never itself, and a later definition of a
+name replaces the earlier one. An imported script contributes its macros
+only, its own code being dropped, and is read once however many times it
+is imported. Comments are left as they are, so '!' and '@' mean nothing
+within them, and are dropped from macros and imported scripts.
+*/
+
+/* Expanded code, with the position in the main script of each byte if kept */
+typedef struct text {
+    char* data;
+    size_t* origin;
+    size_t len, cap;
+} Text;
+
+typedef struct macro {
+    const char* name;
+    size_t name_len;
+    Text code;
+} Macro;
+
+/* Scripts read so far, which macro names point into, and the macros they define */
+typedef struct expander {
+    Macro* macros;
+    size_t macro_count, macro_cap;
+    char** scripts; // imported sources
+    const char** names; // their names as imported, without the extension
+    size_t* name_lens;
+    size_t script_count, script_cap;
+    Expansion* exp;
+} Expander;
+
+static int is_letter(char c){
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static int is_script_char(char c){
+    return is_letter(c) || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+/*
+Appends n bytes to a text, or drops them if it is NULL. The first comes
+from position pos of the main script, and each next one from step further.
+*/
+static Error append(Text* text, const char* s, size_t n, size_t pos, size_t step){
+    size_t i;
+    if (!text) return ERR_OK;
+    if (text->len + n > text->cap){
+        size_t cap = text->cap ? text->cap : 64;
+        char* data;
+        while(cap < text->len + n) cap *= 2;
+        data = realloc(text->data, cap);
+        if (!data) return ERR_UNKNOWN;
+        text->data = data;
+        if (text->origin){
+            size_t* origin = realloc(text->origin, cap * sizeof(size_t));
+            if (!origin) return ERR_UNKNOWN;
+            text->origin = origin;
+        }
+        text->cap = cap;
+    }
+    memcpy(text->data + text->len, s, n);
+    if (text->origin){
+        for(i = 0; i < n; ++i) text->origin[text->len + i] = pos + i * step;
+    }
+    text->len += n;
+    return ERR_OK;
+}
+
+static Error fail(Expander* ex, Error err, size_t where, const char* problem){
+    ex->exp->where = where;
+    ex->exp->problem = problem;
+    return err;
+}
+
+static const Macro* find_macro(const Expander* ex, const char* name, size_t len){
+    size_t i = ex->macro_count;
+    while(i-- > 0){
+        if (ex->macros[i].name_len == len && memcmp(ex->macros[i].name, name, len) == 0) return &ex->macros[i];
+    }
+    return NULL;
+}
+
+static Error add_macro(Expander* ex, const char* name, size_t len, Text code){
+    if (ex->macro_count == ex->macro_cap){
+        size_t cap = ex->macro_cap ? ex->macro_cap * 2 : 16;
+        Macro* macros = realloc(ex->macros, cap * sizeof(Macro));
+        if (!macros) return ERR_UNKNOWN;
+        ex->macros = macros;
+        ex->macro_cap = cap;
+    }
+    ex->macros[ex->macro_count].name = name;
+    ex->macros[ex->macro_count].name_len = len;
+    ex->macros[ex->macro_count].code = code;
+    ex->macro_count++;
+    return ERR_OK;
+}
+
+/* Checks whether a script has been imported already, and notes it as imported if not */
+static int imported(Expander* ex, const char* name, size_t len){
+    size_t i;
+    for(i = 0; i < ex->script_count; ++i){
+        if (ex->name_lens[i] == len && memcmp(ex->names[i], name, len) == 0) return 1;
+    }
+    if (ex->script_count == ex->script_cap){
+        size_t cap = ex->script_cap ? ex->script_cap * 2 : 8;
+        char** scripts = realloc(ex->scripts, cap * sizeof(char*));
+        const char** names = scripts ? realloc(ex->names, cap * sizeof(char*)) : NULL;
+        size_t* name_lens = names ? realloc(ex->name_lens, cap * sizeof(size_t)) : NULL;
+        if (scripts) ex->scripts = scripts;
+        if (names) ex->names = names;
+        if (!name_lens) return 0;
+        ex->name_lens = name_lens;
+        ex->script_cap = cap;
+    }
+    ex->scripts[ex->script_count] = NULL;
+    ex->names[ex->script_count] = name;
+    ex->name_lens[ex->script_count] = len;
+    ex->script_count++;
+    return 0;
+}
+
+static Error expand(Expander* ex, const char* src, size_t size, size_t* i, Text* out, long at, long macro);
+
+/* Reads script name.bf and defines its macros, once */
+static Error import_script(Expander* ex, const char* name, size_t len, size_t where){
+    char path[256];
+    FILE* file;
+    char* src;
+    size_t size = 0, i = 0;
+    size_t n = ex->script_count;
+
+    if (imported(ex, name, len)) return ERR_OK;
+    if (ex->script_count == n) return fail(ex, ERR_UNKNOWN, where, "out of memory");
+    if (len + 4 > sizeof(path)) return fail(ex, ERR_FILE, where, "unable to open imported script");
+    memcpy(path, name, len);
+    memcpy(path + len, ".bf", 4);
+    file = fopen(path, "rb");
+    if (!file) return fail(ex, ERR_FILE, where, "unable to open imported script");
+    src = load_file(file, &size);
+    fclose(file);
+    if (!src) return fail(ex, ERR_FILE, where, "unable to read imported script");
+    ex->scripts[n] = src;
+    return expand(ex, src, size, &i, NULL, (long)where, -1);
+}
+
+/*
+Expands src from *i on into out, or nowhere if out is NULL, up to the '}'
+closing the macro defined at position macro, or to the end of src if
+macro is -1. Positions in the main script are those of src itself if at
+is -1, and at for every byte otherwise.
+*/
+static Error expand(Expander* ex, const char* src, size_t size, size_t* i, Text* out, long at, long macro){
+    Error err = ERR_OK;
+    while(*i < size && err == ERR_OK){
+        size_t start = *i, pos = (at < 0) ? start : (size_t)at;
+        size_t j = start + 1, k;
+        char c = src[start];
+
+        if (c == '(' || c == '#'){
+            // a comment, left for check_matching_brackets to report if it is not closed
+            int level = 1;
+            if (c == '#') j = findc(src, size, start, '\n');
+            else{
+                for(; j < size; ++j){
+                    if (src[j] == '(') level++;
+                    else if (src[j] == ')' && --level == 0) break;
+                }
+            }
+            if (j < size) j++;
+            if (out && out->origin) err = append(out, src + start, j - start, pos, at < 0);
+            *i = j;
+        }
+        else if (c == '}' && macro >= 0){
+            *i = j;
+            return ERR_OK;
+        }
+        else if (c == '!'){
+            while(j < size && is_letter(src[j])) j++;
+            if (j == start + 1) return fail(ex, ERR_MACRO, pos, "missing macro name");
+            for(k = j; k < size && memchr(" \t\r\n", src[k], 4); ++k);
+            if (k < size && src[k] == '{'){
+                Text code = {0};
+                if (macro >= 0) return fail(ex, ERR_MACRO, pos, "macro defined within a macro");
+                *i = k + 1;
+                err = expand(ex, src, size, i, &code, at, (long)start);
+                if (err == ERR_OK) err = add_macro(ex, src + start + 1, j - start - 1, code);
+                if (err != ERR_OK) free(code.data);
+            }
+            else{
+                const Macro* m = find_macro(ex, src + start + 1, j - start - 1);
+                if (!m) return fail(ex, ERR_MACRO, pos, "undefined macro");
+                err = append(out, m->code.data, m->code.len, pos, 0);
+                *i = j;
+            }
+        }
+        else if (c == '@'){
+            while(j < size && is_script_char(src[j])) j++;
+            if (j == start + 1) return fail(ex, ERR_MACRO, pos, "missing script name");
+            err = import_script(ex, src + start + 1, j - start - 1, pos);
+            *i = j;
+        }
+        else{
+            // plain code runs up to the next character with a meaning here
+            while(j < size && !memchr("(#}!@", src[j], 5)) j++;
+            err = append(out, src + start, j - start, pos, at < 0);
+            *i = j;
+        }
+    }
+    if (err == ERR_OK && macro >= 0) return fail(ex, ERR_MACRO, (at < 0) ? (size_t)macro : (size_t)at, "missing '}' closing the macro");
+    if (err == ERR_UNKNOWN && !ex->exp->problem) fail(ex, err, (at < 0) ? *i : (size_t)at, "out of memory");
+    return err;
+}
+
+/*
+Expands the macros and imports of a script. A script that has neither
+is left as it is, and exp then points at it without copying it. On
+failure, exp holds the position in the script of what failed and why.
+*/
+Error expand_macros(const char* src, size_t size, Expansion* exp){
+    Expander ex = {0};
+    Text out = {0};
+    size_t i = 0;
+    Error err;
+
+    memset(exp, 0, sizeof(Expansion));
+    exp->src = src;
+    exp->size = size;
+    if (!memchr(src, '!', size) && !memchr(src, '@', size)) return ERR_OK;
+
+    ex.exp = exp;
+    out.cap = size > 0 ? size : 1;
+    out.data = malloc(out.cap);
+    out.origin = malloc(out.cap * sizeof(size_t));
+    err = (out.data && out.origin) ? expand(&ex, src, size, &i, &out, -1, -1) : ERR_UNKNOWN;
+    if (err == ERR_UNKNOWN && !exp->problem) fail(&ex, err, 0, "out of memory");
+
+    for(i = 0; i < ex.macro_count; ++i) free(ex.macros[i].code.data);
+    for(i = 0; i < ex.script_count; ++i) free(ex.scripts[i]);
+    free(ex.macros);
+    free(ex.scripts);
+    free(ex.names);
+    free(ex.name_lens);
+    if (err != ERR_OK){
+        free(out.data);
+        free(out.origin);
+        return err;
+    }
+    exp->src = out.data;
+    exp->size = out.len;
+    exp->origin = out.origin;
+    return ERR_OK;
+}
+
+void free_expansion(Expansion* exp){
+    if (exp->origin){
+        free((char*)exp->src);
+        free(exp->origin);
+    }
+    exp->src = NULL;
+    exp->origin = NULL;
+    exp->size = 0;
+}
@@ -0,0 +1,518 @@
+#include <limits.h>
+#include <string.h>
+
+#include "brainduck.h"
+
+#define IDIOM_MAX_CELLS 16 // most cells a loop may touch to be replaced
+#define DENSE_MIN_CELLS 16 // fewest cells a run of additions must touch to become OP_ADDS
+#define DENSE_MAX_CELLS 4096 // widest run of additions considered for OP_ADDS
+#define FOLD_MAX_STEPS 1000000 // most instructions evaluated at compile time
+#define FOLD_MAX_CELLS 65536 // most cells tracked at compile time
+
+/* Checks that a move passes through no cell beyond where it starts and ends */
+static int plain_move(const Instr* ins){
+    return ins->offset >= (ins->arg < 0 ? ins->arg : 0) && ins->src <= (ins->arg > 0 ? ins->arg : 0);
+}
+
+/*
+Checks whether the loop opening at code[open] is a clear, move, copy
+or multiply loop: its body only adds to cells and moves the pointer,
+it returns to the cell it started from, and that cell changes by
+exactly one on every iteration.
+The net change of each touched cell is stored in offsets/deltas,
+with the current cell first. Returns the number of cells, or -1.
+*/
+static int match_idiom(const Instr* code, int open, int* offsets, int* deltas){
+    int close = code[open].arg;
+    int count = 1, pos = 0;
+    int ip, i;
+    offsets[0] = 0;
+    deltas[0] = 0;
+    for(ip = open + 1; ip < close; ++ip){
+        if (code[ip].op == OP_MOVE){
+            if (!plain_move(&code[ip])) return -1;
+            pos += code[ip].arg;
+            continue;
+        }
+        if (code[ip].op != OP_ADD) return -1;
+        for(i = 0; i < count && offsets[i] != pos; ++i);
+        if (i == count){
+            if (count == IDIOM_MAX_CELLS) return -1;
+            offsets[count] = pos;
+            deltas[count] = 0;
+            count++;
+        }
+        deltas[i] += code[ip].arg;
+    }
+    if (pos != 0 || (deltas[0] != -1 && deltas[0] != 1)) return -1;
+    return count;
+}
+
+/*
+Links a loop bracket at code[out] into the output of a pass,
+resolving the jump targets of both brackets once a loop is closed.
+*/
+static void link_bracket(Instr* code, size_t out, int* open){
+    if (code[out].op == OP_OPEN){
+        code[out].arg = *open;
+        *open = (int)out;
+    }
+    else{
+        int match = *open;
+        *open = code[match].arg;
+        code[match].arg = (int)out;
+        code[out].arg = match;
+    }
+}
+
+/*
+Replaces common loop idioms with constant time instructions:
+    [-] and [+]  become OP_CLEAR
+    [->+<]       becomes OP_MULADD to offset 1, then OP_CLEAR
+    [->+>+<<]    becomes one OP_MULADD per target cell, then OP_CLEAR
+    [>] and [<<] become OP_SCAN with the loop's stride
+A loop that counts up rather than down runs -x times modulo the cell size,
+so its coefficients are negated. Clears and scans keep the steps of the
+loop they replace, for the engines to charge the times it would go round.
+The program is rewritten in place and its jump targets are rebuilt.
+*/
+static void replace_idioms(Program* prog){
+    Instr* code = prog->code;
+    int offsets[IDIOM_MAX_CELLS], deltas[IDIOM_MAX_CELLS];
+    int open = -1; // innermost unmatched loop in the output, earlier ones linked through arg
+    size_t in, out = 0;
+    int count, i;
+
+    for(in = 0; in < prog->len; ++in){
+        Instr ins = code[in];
+        if (ins.op == OP_OPEN && code[in + 1].op == OP_MOVE && code[in + 2].op == OP_CLOSE && plain_move(&code[in + 1])){
+            code[out].op = OP_SCAN;
+            code[out].arg = code[in + 1].arg;
+            code[out].lo = code[out].hi = 0;
+            code[out].steps = code[in + 2].steps;
+            out++;
+            in += 2;
+            continue;
+        }
+        if (ins.op == OP_OPEN && (count = match_idiom(code, (int)in, offsets, deltas)) > 0){
+            unsigned steps = code[ins.arg].steps;
+            for(i = 1; i < count; ++i){
+                if (deltas[i] == 0) continue;
+                code[out].op = OP_MULADD;
+                code[out].arg = -deltas[0] * deltas[i];
+                code[out].offset = offsets[i];
+                code[out].src = 0;
+                code[out].steps = 0;
+                out++;
+            }
+            code[out].op = OP_CLEAR;
+            code[out].arg = deltas[0];
+            code[out].offset = 0;
+            code[out].src = 0;
+            code[out].steps = steps;
+            out++;
+            in = ins.arg; // skip to the closing bracket
+            continue;
+        }
+        code[out] = ins;
+        if (ins.op == OP_OPEN || ins.op == OP_CLOSE) link_bracket(code, out, &open);
+        out++;
+    }
+    prog->len = out;
+}
+
+/*
+Deletes loops that can never be entered, because they open on a cell
+known to be zero: at the start of the program, or right after another
+loop, a scan or a clear of the same cell, as in the comment loop [...]
+at the top of a script.
+The program is rewritten in place and its jump targets are rebuilt.
+*/
+static void remove_dead_loops(Program* prog){
+    Instr* code = prog->code;
+    int open = -1;
+    int zero = 1; // the current cell is known to be zero
+    size_t in, out = 0;
+
+    for(in = 0; in < prog->len; ++in){
+        Instr ins = code[in];
+        if (ins.op == OP_OPEN && zero){
+            in = ins.arg; // skip to the closing bracket
+            continue;
+        }
+        code[out] = ins;
+        if (ins.op == OP_OPEN || ins.op == OP_CLOSE) link_bracket(code, out, &open);
+        out++;
+        switch(ins.op){
+            case OP_CLOSE: case OP_SCAN: case OP_CLEAR: zero = 1; break;
+            case OP_OUT: case OP_OUT_NUM: case OP_MULADD: case OP_CHECK: break; // the current cell is unchanged
+            default: zero = 0; break;
+        }
+    }
+    prog->len = out;
+}
+
+/*
+Records the span of cells reached by the part of a block that follows head.
+A check after I/O is left with nothing to do if the parts before it
+already checked every cell its part reaches.
+*/
+static void close_part(Program* prog, long head, int lo, int hi, int* checked_lo, int* checked_hi){
+    if (head >= 0 && prog->code[head].op == OP_CHECK && lo >= *checked_lo && hi <= *checked_hi) lo = hi = 0;
+    if (lo < *checked_lo) *checked_lo = lo;
+    if (hi > *checked_hi) *checked_hi = hi;
+    set_block_range(prog, head, lo, hi);
+}
+
+/*
+Addresses cells by their offset from the stack pointer on entry to each
+basic block, so that a block such as >+>+<< becomes ADD 1 @1, ADD 1 @2
+and the pointer moves once, by the net amount, at the end of the block.
+The span of cells each block reaches is recorded for bounds checking,
+including cells that moves only pass through. Where a block moves on
+after I/O, an OP_CHECK splits it, covering whatever cells the rest of
+the block reaches beyond those checked already. Blocks are only known
+here, once other passes have merged some, so the checks placed by
+compile_program are dropped and placed again.
+The program is rewritten into a new buffer with room for the checks,
+or in place without them if there is no memory for one.
+*/
+static void offset_blocks(Program* prog){
+    const Instr* code = prog->code;
+    Instr* rewritten = malloc((2 * prog->len + 1) * sizeof(Instr));
+    int open = -1;
+    long head = -1; // loop bracket or check preceding the current part of the block
+    int pos = 0, lo = 0, hi = 0;
+    int checked_lo = 0, checked_hi = 0; // cells checked by the parts of the block before
+    int io = 0; // the current part of the block does I/O
+    size_t in, out = 0;
+
+    if (rewritten) prog->code = rewritten;
+    for(in = 0; in < prog->len; ++in){
+        Instr ins = code[in];
+        switch(ins.op){
+            case OP_MOVE:
+                if (io && rewritten){
+                    close_part(prog, head, lo, hi, &checked_lo, &checked_hi);
+                    lo = hi = pos;
+                    prog->code[out].op = OP_CHECK;
+                    prog->code[out].arg = 0;
+                    prog->code[out].steps = 0;
+                    head = (long)out++;
+                    io = 0;
+                }
+                if (pos + ins.offset < lo) lo = pos + ins.offset;
+                if (pos + ins.src > hi) hi = pos + ins.src;
+                pos += ins.arg;
+                if (pos < lo) lo = pos;
+                if (pos > hi) hi = pos;
+                continue;
+            case OP_CHECK: continue;
+            case OP_OUT: case OP_IN: case OP_OUT_NUM: case OP_IN_NUM:
+                io = 1;
+                ins.offset = pos;
+                break;
+            case OP_MULADD:
+                ins.src = pos;
+                ins.offset += pos;
+                break;
+            case OP_OPEN: case OP_CLOSE: case OP_SCAN:
+                if (pos != 0){
+                    prog->code[out].op = OP_MOVE;
+                    prog->code[out].arg = pos;
+                    prog->code[out].offset = prog->code[out].src = 0;
+                    prog->code[out].steps = 0;
+                    out++;
+                }
+                close_part(prog, head, lo, hi, &checked_lo, &checked_hi);
+                pos = lo = hi = 0;
+                checked_lo = checked_hi = 0;
+                io = 0;
+                prog->code[out] = ins;
+                if (ins.op != OP_SCAN) link_bracket(prog->code, out, &open);
+                head = (long)out++;
+                continue;
+            default:
+                ins.offset = pos;
+                break;
+        }
+        prog->code[out++] = ins;
+    }
+    if (pos != 0){
+        prog->code[out].op = OP_MOVE;
+        prog->code[out].arg = pos;
+        prog->code[out].offset = prog->code[out].src = 0;
+        prog->code[out].steps = 0;
+        out++;
+    }
+    close_part(prog, head, lo, hi, &checked_lo, &checked_hi);
+    prog->len = out;
+    if (rewritten) free((Instr*)code);
+}
+
+/*
+Looks for the run of additions starting at code[in] that can become a
+single OP_ADDS: it touches at least DENSE_MIN_CELLS cells, which fill
+at least half of the span between its lowest and highest offset.
+On success, appends the pattern to the program's data and stores the
+OP_ADDS in packed. Either way, returns the length of the run, so that
+a rejected run is not looked at again from each of its additions.
+*/
+static size_t pack_run(Program* prog, size_t in, Instr* packed){
+    const Instr* code = prog->code;
+    long deltas[DENSE_MAX_CELLS];
+    int lo = code[in].offset, hi = code[in].offset;
+    size_t end, i, count = 0, bytes, span;
+    char* data;
+
+    for(end = in; end < prog->len && code[end].op == OP_ADD; ++end){
+        if (code[end].offset < lo) lo = code[end].offset;
+        if (code[end].offset > hi) hi = code[end].offset;
+    }
+    if (end - in < DENSE_MIN_CELLS || hi - lo >= DENSE_MAX_CELLS) return end - in;
+    span = (size_t)(hi - lo + 1);
+    memset(deltas, 0, span * sizeof(long));
+    for(i = in; i < end; ++i) deltas[code[i].offset - lo] += code[i].arg;
+    for(i = 0; i < span; ++i) count += (deltas[i] != 0);
+    if (count < DENSE_MIN_CELLS || span > 2 * count) return end - in;
+
+    bytes = span << cell_shift;
+    data = realloc(prog->data, prog->data_len + bytes);
+    if (!data) return end - in;
+    for(i = 0; i < span; ++i){
+        set_cell(data + prog->data_len + (i << cell_shift), (unsigned long)deltas[i]);
+    }
+    packed->op = OP_ADDS;
+    packed->arg = (int)prog->data_len;
+    packed->offset = lo;
+    packed->src = (int)span;
+    prog->data = data;
+    prog->data_len += bytes;
+    return end - in;
+}
+
+/*
+Replaces dense runs of additions within a block, such as the ones
+building a table of constants, with OP_ADDS, which applies them
+to all cells at once with vector instructions.
+Runs only after offset_blocks, when the additions of a block are no
+longer interleaved with moves. The program is rewritten in place and
+its jump targets are rebuilt.
+*/
+static void pack_dense_blocks(Program* prog){
+    Instr* code = prog->code;
+    int open = -1;
+    size_t in, out = 0, run;
+
+    for(in = 0; in < prog->len; ++in){
+        Instr ins = code[in];
+        if (ins.op == OP_ADD){
+            run = pack_run(prog, in, &ins);
+            if (ins.op == OP_ADD){ // kept as it is
+                memmove(&code[out], &code[in], run * sizeof(Instr));
+                out += run;
+                in += run - 1;
+                continue;
+            }
+            in += run - 1;
+        }
+        code[out] = ins;
+        if (ins.op == OP_OPEN || ins.op == OP_CLOSE) link_bracket(code, out, &open);
+        out++;
+    }
+    prog->len = out;
+}
+
+/*
+Checks whether the block from code[ip] on can be evaluated at compile time
+with the stack pointer at pos: it reads no input, and every cell it reaches
+lies within the n cells tracked. Returns the index of the loop bracket or
+scan that ends the block, or -1.
+*/
+static long foldable_block(const Program* prog, size_t ip, long pos, int lo, int hi, long n){
+    const Instr* code = prog->code;
+    if (pos + lo < 0 || pos + hi >= n) return -1;
+    for(; ip < prog->len; ++ip){
+        const Instr* ins = &code[ip];
+        if (ins->op == OP_OPEN || ins->op == OP_CLOSE || ins->op == OP_SCAN) break;
+        if (ins->op == OP_IN || ins->op == OP_IN_NUM) return -1;
+        if (ins->op == OP_MULADD && (pos + ins->offset < 0 || pos + ins->offset >= n)) return -1;
+        if (ins->op == OP_CHECK && (pos + ins->lo < 0 || pos + ins->hi >= n)) return -1;
+    }
+    return (long)ip;
+}
+
+/* Adds the steps of a loop going round times more to a total, which sticks at its maximum */
+static void add_loop_steps(unsigned long long* total, unsigned long long times, unsigned steps){
+    if (steps > 0 && times > (ULLONG_MAX - *total) / steps) *total = ULLONG_MAX;
+    else *total += times * steps;
+}
+
+/*
+Evaluates the start of the program at compile time, since the stack is
+known to be zero: blocks are run one at a time, up to the first one that
+reads input, leaves the cells tracked, or follows FOLD_MAX_STEPS
+instructions. The cells and output produced are stored in the program,
+which then starts from the first block left, along with the steps of
+--max-steps its loops took. A prefix taking more steps than allowed is
+not kept, so that the run stops where it would have otherwise.
+*/
+static void fold_prefix(Program* prog){
+    const Instr* code = prog->code;
+    unsigned long mask = (cell_shift == 2) ? 0xFFFFFFFFUL : (1UL << (8 << cell_shift)) - 1;
+    long n = (tape_size < FOLD_MAX_CELLS) ? (long)tape_size : FOLD_MAX_CELLS;
+    unsigned long* cells = calloc((size_t)n, sizeof(unsigned long));
+    char* output = NULL;
+    size_t output_len = 0, output_cap = 0;
+    size_t ip = 0, steps = 0;
+    unsigned long long charged = 0; // steps of --max-steps
+    long pos = 0, top = 0, end, i;
+    int lo = prog->lo, hi = prog->hi;
+
+    if (!cells) return;
+    while(ip < prog->len && (end = foldable_block(prog, ip, pos, lo, hi, n)) >= 0){
+        size_t next;
+        if ((steps += (size_t)end - ip + 1) > FOLD_MAX_STEPS) break;
+        if (pos + hi > top) top = pos + hi;
+        for(; ip < (size_t)end; ++ip){
+            const Instr* ins = &code[ip];
+            unsigned long* c = &cells[pos + ins->offset];
+            switch(ins->op){
+                case OP_ADD: *c = (*c + (unsigned long)ins->arg) & mask; break;
+                case OP_MOVE: pos += ins->arg; break;
+                case OP_CLEAR:
+                    if (*c != 0) add_loop_steps(&charged, ((ins->arg < 0 ? *c : (0 - *c) & mask)) - 1, ins->steps);
+                    *c = 0;
+                    break;
+                case OP_CHECK: if (pos + ins->hi > top) top = pos + ins->hi; break;
+                case OP_MULADD: // reaching its cell only if the loop it replaces runs
+                    if (cells[pos + ins->src] == 0) break;
+                    *c = (*c + cells[pos + ins->src] * (unsigned long)ins->arg) & mask;
+                    if (pos + ins->offset > top) top = pos + ins->offset;
+                    break;
+                case OP_ADDS:
+                    for(i = 0; i < ins->src; ++i){
+                        c[i] = (c[i] + get_cell(prog->data + ins->arg + (i << cell_shift))) & mask;
+                    }
+                    break;
+                case OP_OUT: case OP_OUT_NUM:
+                    if (output_cap - output_len < NUMBER_SIZE){
+                        char* grown = realloc(output, output_cap = 2 * output_cap + 64);
+                        if (!grown){
+                            free(output);
+                            free(cells);
+                            return; // midway through a block, nothing can be kept
+                        }
+                        output = grown;
+                    }
+                    if (ins->op == OP_OUT_NUM) output_len += format_number(output + output_len, *c);
+                    else output[output_len++] = (char)*c;
+                    break;
+                default: break;
+            }
+        }
+        if (ip == prog->len){
+            lo = hi = 0; // nothing left to run
+            break;
+        }
+
+        /* Loop bracket or scan, which decides where the next block starts */
+        switch(code[ip].op){
+            case OP_OPEN: next = (cells[pos] == 0) ? (size_t)code[ip].arg : ip; break;
+            case OP_CLOSE:
+                next = (cells[pos] != 0) ? (size_t)code[ip].arg : ip;
+                if (next != ip) add_loop_steps(&charged, 1, code[ip].steps);
+                break;
+            default:
+                for(i = pos; i >= 0 && i < n && cells[i] != 0; i += code[ip].arg);
+                if (i < 0 || i >= n){
+                    lo = hi = 0; // resumes at the scan itself
+                    goto done;
+                }
+                if (i != pos) add_loop_steps(&charged, (unsigned long long)((i - pos) / code[ip].arg - 1), code[ip].steps);
+                pos = i;
+                if (pos > top) top = pos;
+                next = ip;
+                break;
+        }
+        lo = code[next].lo;
+        hi = code[next].hi;
+        ip = next + 1;
+    }
+
+done:
+    if (ip > 0 && (max_steps == 0 || charged <= max_steps)){
+        size_t bytes = (size_t)(top + 1) << cell_shift;
+        char* tape = malloc(bytes);
+        if (tape){
+            for(i = 0; i <= top; ++i) set_cell(tape + (i << cell_shift), cells[i]);
+            prog->entry = ip;
+            prog->entry_pos = pos;
+            prog->lo = lo;
+            prog->hi = hi;
+            prog->tape = tape;
+            prog->tape_len = bytes;
+            prog->output = output;
+            prog->output_len = output_len;
+            prog->entry_steps = charged;
+            output = NULL;
+        }
+    }
+    free(output);
+    free(cells);
+}
+
+/* Records the lowest and highest offset from the stack pointer that any instruction reaches */
+static void measure_reach(Program* prog){
+    int lo = prog->lo, hi = prog->hi;
+    size_t ip;
+    for(ip = 0; ip < prog->len; ++ip){
+        const Instr* ins = &prog->code[ip];
+        int first, last;
+        switch(ins->op){
+            case OP_MOVE: continue;
+            case OP_OPEN: case OP_CLOSE: case OP_SCAN: case OP_CHECK: first = ins->lo; last = ins->hi; break;
+            case OP_MULADD:
+                first = (ins->offset < ins->src) ? ins->offset : ins->src;
+                last = (ins->offset > ins->src) ? ins->offset : ins->src;
+                break;
+            case OP_ADDS: first = ins->offset; last = ins->offset + ins->src - 1; break;
+            default: first = last = ins->offset; break;
+        }
+        if (first < lo) lo = first;
+        if (last > hi) hi = last;
+    }
+    prog->reach_lo = lo;
+    prog->reach_hi = hi;
+}
+
+/* Runs every optimization pass over the program */
+void optimize_program(Program* prog){
+    replace_idioms(prog);
+    remove_dead_loops(prog);
+    offset_blocks(prog);
+    pack_dense_blocks(prog);
+    fold_prefix(prog);
+    measure_reach(prog);
+}
+
+/*
+With guard pages of 'below' cells before the stack and 'above' cells
+after it, a block whose cells lie within that distance of the stack
+pointer on one side needs no bounds check on that side: any access that
+leaves the stack faults on the guard pages instead. Every block starts
+by reading its current cell, which was reached by a move that was either
+checked or no longer than the guard, so the pointer can never skip past it.
+Scans stay within the stack by themselves.
+*/
+void relax_bounds_checks(Program* prog, int below, int above){
+    size_t ip;
+    if (prog->lo >= -below) prog->lo = 0;
+    if (prog->hi <= above) prog->hi = 0;
+    for(ip = 0; ip < prog->len; ++ip){
+        Instr* ins = &prog->code[ip];
+        if (ins->op != OP_OPEN && ins->op != OP_CLOSE && ins->op != OP_SCAN && ins->op != OP_CHECK) continue;
+        if (ins->lo >= -below) ins->lo = 0;
+        if (ins->hi <= above) ins->hi = 0;
+    }
+}
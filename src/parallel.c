@@ -0,0 +1,324 @@
+#include <pthread.h>
+#include <string.h>
+
+#include "brainduck.h"
+
+/*
+Parallel runs of independent parts of a program, for --parallel.
+
+The top level of a program is a list of items: instructions outside of
+any loop, and whole loops. An item can be placed on the stack when the
+stack pointer only moves by known amounts within it, that is, it holds
+no scan and all of its loops end where they started, and it does no I/O.
+A region is a run of such items, in which every cell is known relative
+to the stack pointer at its start.
+
+A region is cut between two items wherever no cell reached before the
+cut is reached after it. The segments between the cuts then touch
+disjoint cells, so they can run at the same
+time, each on a thread of its own sharing the stack. Segments without
+loops are not worth a thread and are merged into a neighbour. Anything
+that is not part of a region of two segments or more runs in order on
+the calling thread, as does a region found to reach beyond the stack
+when it is about to run.
+*/
+
+/* Cells lo to hi, relative to the start of a region, or none if lo > hi */
+typedef struct span {
+    long lo, hi;
+} Span;
+
+/* Top-level instruction or loop of a region */
+typedef struct item {
+    size_t start, end; // instructions start to end - 1
+    long pos; // stack pointer at start, relative to the start of the region
+    Span cells; // read or written
+    Span checked; // checked to lie within the stack by its loop brackets
+    int loop;
+} Item;
+
+/* Part of a region run on one thread */
+typedef struct segment {
+    Program prog; // runs the instructions of the segment only
+    long pos;
+    Context* context;
+    Error err;
+    pthread_t thread;
+} Segment;
+
+#define REGION_MAX_CELLS (1L << 24) // most cells gone through to find where a region can be cut
+
+int parallel_threads = 0; // threads running independent segments of a program at once, or 0 to run it in order
+
+static void widen(Span* span, long lo, long hi){
+    if (span->lo > span->hi){
+        span->lo = lo;
+        span->hi = hi;
+        return;
+    }
+    if (lo < span->lo) span->lo = lo;
+    if (hi > span->hi) span->hi = hi;
+}
+
+static Span none(){
+    Span span = {1, 0};
+    return span;
+}
+
+/* Runs instructions from to to - 1 of a program in order, checking the first block only if first */
+static Error run_serial(const Program* prog, size_t from, size_t to, int first){
+    Program part = *prog;
+    part.entry = from;
+    part.len = to;
+    if (!first) part.lo = part.hi = 0; // checked by the instruction that started the block
+    return execute_serial(&part);
+}
+
+static void* run_segment(void* arg){
+    Segment* seg = arg;
+    ctx = seg->context;
+    seg->err = execute_serial(&seg->prog);
+    return NULL;
+}
+
+/*
+Runs the count segments of a region at once, from the current stack pointer,
+segment i starting seg[i].pos cells from it. reach holds every cell the
+region reaches, which all lie within the stack.
+*/
+static Error run_segments(Segment* seg, int count, Span reach){
+    char* base = ctx->stackptr;
+    Error err = ERR_OK;
+    int i, started = 0;
+
+    for(i = 1; i < count; ++i){
+        seg[i].context = malloc(sizeof(Context));
+        if (!seg[i].context) break;
+        memcpy(seg[i].context, ctx, sizeof(Context));
+        seg[i].context->stats.steps = seg[i].context->stats.iterations = 0; // added back once joined
+        seg[i].context->stackptr = base + (seg[i].pos << cell_shift);
+        if (pthread_create(&seg[i].thread, NULL, run_segment, &seg[i]) != 0){
+            free(seg[i].context);
+            break;
+        }
+        started++;
+    }
+    // segments that did not get a thread run here, after the first one
+    ctx->stackptr = base + (seg[0].pos << cell_shift);
+    err = execute_serial(&seg[0].prog);
+    for(i = started + 1; i < count && err == ERR_OK; ++i){
+        ctx->stackptr = base + (seg[i].pos << cell_shift);
+        err = execute_serial(&seg[i].prog);
+    }
+    for(i = 1; i <= started; ++i){
+        pthread_join(seg[i].thread, NULL);
+        if (err == ERR_OK) err = seg[i].err;
+        COUNT(steps, seg[i].context->stats.steps);
+        COUNT(iterations, seg[i].context->stats.iterations);
+        if (seg[i].context->reached_lo < ctx->reached_lo) ctx->reached_lo = seg[i].context->reached_lo;
+        if (seg[i].context->reached_hi > ctx->reached_hi) ctx->reached_hi = seg[i].context->reached_hi;
+        free(seg[i].context);
+    }
+    touch_cells(base, base, reach.lo, reach.hi); // the others wrote through contexts of their own
+    ctx->stackptr = base;
+    return err;
+}
+
+/*
+Marks the items of a region that may start a segment of their own: item i
+may if no cell reached by an item before it is reached by item i or one
+after it. Every cell notes the first and last items reaching it, which
+rules out all the items after the first up to the last. Returns 0 if the
+cells of the region are too many to go through.
+*/
+static int find_cuts(const Item* items, size_t count, char* cut){
+    size_t i, *first = NULL, *last = NULL;
+    long* ruled = calloc(count + 1, sizeof(long)); // changes in how many cells rule out each item
+    long c, width, work, n = 0;
+    Span cells = none();
+
+    for(i = 0; i < count; ++i){
+        if (items[i].cells.lo <= items[i].cells.hi) widen(&cells, items[i].cells.lo, items[i].cells.hi);
+    }
+    width = work = cells.hi - cells.lo + 1;
+    for(i = 0; i < count && work <= REGION_MAX_CELLS; ++i) work += items[i].cells.hi - items[i].cells.lo + 1;
+    if (ruled && work <= REGION_MAX_CELLS && width > 0){
+        first = malloc((size_t)width * sizeof(size_t));
+        last = malloc((size_t)width * sizeof(size_t));
+    }
+    if (!first || !last){
+        free(ruled);
+        free(first);
+        free(last);
+        return 0;
+    }
+
+    for(c = 0; c < width; ++c) first[c] = count;
+    for(i = 0; i < count; ++i){
+        for(c = items[i].cells.lo; c <= items[i].cells.hi; ++c){
+            if (first[c - cells.lo] == count) first[c - cells.lo] = i;
+            last[c - cells.lo] = i;
+        }
+    }
+    for(c = 0; c < width; ++c){
+        if (first[c] == count || first[c] == last[c]) continue;
+        ruled[first[c] + 1]++;
+        ruled[last[c] + 1]--;
+    }
+    for(i = 0; i < count; ++i){
+        n += ruled[i];
+        cut[i] = (i == 0 || n == 0);
+    }
+    free(ruled);
+    free(first);
+    free(last);
+    return 1;
+}
+
+/*
+Splits the region made of items[0] to items[count - 1] into at most
+parallel_threads segments touching disjoint cells, and runs it if there are
+at least two. Everything from *done up to the region runs first, and *done
+moves past the region. Regions that are not run are left to run in order.
+*/
+static Error run_region(const Program* prog, const Item* items, size_t count, long end_pos, Span reach,
+                        size_t* done, int* first){
+    char* cut = malloc(count); // items that may start a segment
+    size_t* cuts = malloc((count + 1) * sizeof(size_t)); // first item of each segment
+    Segment* seg = NULL;
+    size_t i, n = 0, kept = 0;
+    long at;
+    Error err = ERR_OK;
+
+    if (!cut || !cuts || !find_cuts(items, count, cut)) goto out;
+    for(i = 0; i < count; ++i){
+        if (cut[i]) cuts[n++] = i;
+    }
+    cuts[n] = count;
+
+    // a segment without loops joins the one before it, or the first one after it if it leads
+    for(i = 0; i < n; ++i){
+        size_t j;
+        int loop = 0;
+        for(j = cuts[i]; j < cuts[i + 1]; ++j) loop |= items[j].loop;
+        if (loop) cuts[kept++] = cuts[i];
+    }
+    if (kept > 0) cuts[0] = 0;
+    n = kept;
+    if ((long)n > parallel_threads){
+        // deal whole segments out evenly among the threads
+        for(i = 0; i < (size_t)parallel_threads; ++i) cuts[i] = cuts[i * n / (size_t)parallel_threads];
+        n = (size_t)parallel_threads;
+    }
+    cuts[n] = count;
+    if (n < 2) goto out;
+
+    seg = calloc(n, sizeof(Segment));
+    if (!seg) goto out;
+    for(i = 0; i < n; ++i){
+        seg[i].prog = *prog;
+        seg[i].prog.entry = items[cuts[i]].start;
+        seg[i].prog.len = items[cuts[i + 1] - 1].end;
+        seg[i].prog.lo = seg[i].prog.hi = 0;
+        seg[i].pos = items[cuts[i]].pos;
+    }
+    err = run_serial(prog, *done, items[0].start, *first);
+    *done = items[0].start;
+    *first = 0;
+    if (err != ERR_OK) goto out;
+
+    // a region that leaves the stack fails or grows it at some point, so it runs in order
+    at = (long)((size_t)(ctx->stackptr - ctx->stack) >> cell_shift);
+    widen(&reach, end_pos, end_pos);
+    if (at + reach.lo < 0 || at + reach.hi >= (long)ctx->stack_size) goto out;
+    err = run_segments(seg, (int)n, reach);
+    if (err == ERR_OK){
+        ctx->stackptr += end_pos << cell_shift;
+        *done = items[count - 1].end;
+    }
+out:
+    free(cut);
+    free(cuts);
+    free(seg);
+    return err;
+}
+
+/* Adds the cells an instruction reads or writes with the stack pointer at pos to cells */
+static int reach_cells(const Instr* ins, long pos, Span* cells){
+    switch(ins->op){
+        case OP_ADD: case OP_CLEAR: widen(cells, pos + ins->offset, pos + ins->offset); return 1;
+        case OP_MULADD:
+            widen(cells, pos + ins->offset, pos + ins->offset);
+            widen(cells, pos + ins->src, pos + ins->src);
+            return 1;
+        case OP_ADDS: widen(cells, pos + ins->offset, pos + ins->offset + ins->src - 1); return 1;
+        case OP_OPEN: case OP_CLOSE: widen(cells, pos, pos); return 1; // test the current cell
+        case OP_MOVE: return 1;
+        default: return 0; // I/O and scans
+    }
+}
+
+/*
+Runs a program like execute_serial does, with the independent segments
+of any region run at the same time on parallel_threads threads.
+*/
+Error execute_parallel(const Program* prog){
+    Item* items = malloc((prog->len + 1) * sizeof(Item));
+    long* open_pos = malloc((prog->len + 1) * sizeof(long)); // stack pointer at each OP_OPEN
+    size_t ip, count = 0, done = prog->entry;
+    int first = 1, depth = 0, placed = 1;
+    long pos = 0;
+    Span reach = none();
+    Item item;
+    Error err = ERR_OK;
+
+    if (!items || !open_pos){
+        free(items);
+        free(open_pos);
+        return execute_serial(prog);
+    }
+    for(ip = prog->entry; ip < prog->len && err == ERR_OK; ++ip){
+        const Instr* ins = &prog->code[ip];
+        if (depth == 0){
+            item.start = ip;
+            item.pos = pos;
+            item.cells = item.checked = none();
+            item.loop = ins->op == OP_OPEN;
+            placed = 1;
+        }
+        if (!reach_cells(ins, pos, &item.cells)) placed = 0;
+        if (ins->op == OP_MOVE) pos += ins->arg;
+        else if (ins->op == OP_OPEN){
+            open_pos[ip] = pos;
+            widen(&item.checked, pos + ins->lo, pos + ins->hi);
+            depth++;
+        }
+        else if (ins->op == OP_CLOSE){
+            widen(&item.checked, pos + ins->lo, pos + ins->hi);
+            if (depth == 0) placed = 0; // closes a loop entered before the program started, on resuming
+            else{
+                if (pos != open_pos[ins->arg]) placed = 0;
+                depth--;
+            }
+        }
+        if (depth > 0) continue;
+
+        item.end = ip + 1;
+        if (placed){
+            if (item.cells.lo <= item.cells.hi) widen(&reach, item.cells.lo, item.cells.hi);
+            if (item.checked.lo <= item.checked.hi) widen(&reach, item.checked.lo, item.checked.hi);
+            items[count++] = item;
+            continue;
+        }
+        // the stack pointer is lost here: whatever came before is a region of its own
+        if (count > 0) err = run_region(prog, items, count, item.pos, reach, &done, &first);
+        count = 0;
+        pos = 0;
+        reach = none();
+    }
+    if (err == ERR_OK && count > 0) err = run_region(prog, items, count, pos, reach, &done, &first);
+    if (err == ERR_OK) err = run_serial(prog, done, prog->len, first);
+    free(items);
+    free(open_pos);
+    return err;
+}
@@ -0,0 +1,149 @@
+#include <string.h>
+
+#include "brainduck.h"
+
+/*
+Profiler behind --profile: runs an unoptimised program while counting
+how many times each instruction runs, then sums the counts over every
+loop. Loops are reported by their range in the source, from the '['
+to the matching ']', so the program has to be compiled with the source
+position of each instruction.
+*/
+
+#define PROFILE_TABLE_ROWS 10 // loops listed by the table, the JSON report has them all
+
+/* Runs a program from the current stack pointer, adding up how many times each instruction runs */
+static Error count_steps(const Program* prog, unsigned long long* counts){
+    size_t ip;
+    for(ip = 0; ip < prog->len; ++ip){
+        const Instr* ins = &prog->code[ip];
+        if (ins->op == OP_CHECK) continue; // each move is checked here, and a check is no command of the script
+        counts[ip]++;
+        switch(ins->op){
+            case OP_ADD: set_cell(ctx->stackptr, get_cell(ctx->stackptr) + (unsigned long)(long)ins->arg); break;
+            case OP_MOVE:
+                if (check_cell(ins->offset) != ERR_OK || check_cell(ins->src) != ERR_OK) return ERR_BOUNDS;
+                ctx->stackptr += (long)ins->arg << cell_shift;
+                break;
+            case OP_OUT: print_byte((char)get_cell(ctx->stackptr)); break;
+            case OP_IN: set_cell(ctx->stackptr, (unsigned long)input_byte((long)get_cell(ctx->stackptr))); break;
+            case OP_OUT_NUM: print_number(get_cell(ctx->stackptr)); break;
+            case OP_IN_NUM: set_cell(ctx->stackptr, (unsigned long)input_number((long)get_cell(ctx->stackptr))); break;
+            case OP_OPEN: if (get_cell(ctx->stackptr) == 0) ip = ins->arg; break;
+            case OP_CLOSE: if (get_cell(ctx->stackptr) != 0) ip = ins->arg; break;
+            default: break; // only made by the optimizer
+        }
+    }
+    return ERR_OK;
+}
+
+/* Orders loops by the instructions run within them, most first */
+static int compare_loops(const void* a, const void* b){
+    const LoopProfile* x = a;
+    const LoopProfile* y = b;
+    if (x->steps != y->steps) return (x->steps < y->steps) ? 1 : -1;
+    if (x->line != y->line) return (x->line < y->line) ? -1 : 1;
+    return (x->column < y->column) ? -1 : (x->column > y->column);
+}
+
+/*
+Runs a program compiled by compile_program, without optimizing it,
+and fills in the profile, even if the run fails.
+where holds the source position of each instruction in src.
+*/
+Error profile_program(const Program* prog, const size_t* where, const char* src, Profile* profile){
+    unsigned long long* counts = calloc(prog->len > 0 ? prog->len : 1, sizeof(unsigned long long));
+    unsigned long long* before = malloc((prog->len + 1) * sizeof(unsigned long long)); // steps before each instruction
+    int* lines = malloc((prog->len > 0 ? prog->len : 1) * 2 * sizeof(int)); // line and column of each instruction
+    size_t ip, pos = 0;
+    int line = 1, column = 1;
+    Error err;
+
+    memset(profile, 0, sizeof(Profile));
+    if (!counts || !before || !lines){
+        free(counts);
+        free(before);
+        free(lines);
+        return ERR_UNKNOWN;
+    }
+
+    touch_stack();
+    err = count_steps(prog, counts);
+
+    // positions only ever increase along the program, so the source is walked once
+    before[0] = 0;
+    for(ip = 0; ip < prog->len; ++ip){
+        before[ip + 1] = before[ip] + counts[ip];
+        for(; pos < where[ip]; ++pos){
+            if (src[pos] == '\n'){
+                line++;
+                column = 1;
+            }
+            else column++;
+        }
+        lines[2 * ip] = line;
+        lines[2 * ip + 1] = column;
+        if (prog->code[ip].op == OP_OPEN) profile->loop_count++;
+    }
+    profile->steps = before[prog->len];
+
+    profile->loops = calloc(profile->loop_count > 0 ? profile->loop_count : 1, sizeof(LoopProfile));
+    if (profile->loops){
+        LoopProfile* loop = profile->loops;
+        for(ip = 0; ip < prog->len; ++ip){
+            size_t end = (size_t)prog->code[ip].arg;
+            if (prog->code[ip].op != OP_OPEN) continue;
+            loop->line = lines[2 * ip];
+            loop->column = lines[2 * ip + 1];
+            loop->end_line = lines[2 * end];
+            loop->end_column = lines[2 * end + 1];
+            loop->entries = counts[ip];
+            loop->iterations = counts[end];
+            loop->steps = before[end + 1] - before[ip];
+            loop++;
+        }
+        qsort(profile->loops, profile->loop_count, sizeof(LoopProfile), compare_loops);
+    }
+    else{
+        profile->loop_count = 0;
+        err = ERR_UNKNOWN;
+    }
+
+    free(counts);
+    free(before);
+    free(lines);
+    return err;
+}
+
+/* Prints the hottest loops as a table, or all of them as JSON */
+void print_profile(const Profile* profile, ProfileFormat format){
+    size_t i;
+    if (format == PROFILE_JSON){
+        printf("{\"instructions\": %llu, \"loops\": [", profile->steps);
+        for(i = 0; i < profile->loop_count; ++i){
+            const LoopProfile* loop = &profile->loops[i];
+            printf("%s\n  {\"start\": {\"line\": %d, \"column\": %d}, \"end\": {\"line\": %d, \"column\": %d}, "
+                   "\"entries\": %llu, \"iterations\": %llu, \"instructions\": %llu}",
+                   i ? "," : "", loop->line, loop->column, loop->end_line, loop->end_column,
+                   loop->entries, loop->iterations, loop->steps);
+        }
+        printf("%s]}\n", profile->loop_count ? "\n" : "");
+        return;
+    }
+
+    printf("\n --- Profile: %llu instructions ---\n", profile->steps);
+    printf("%-17s %12s %12s %12s %7s\n", "loop", "instructions", "iterations", "entries", "share");
+    for(i = 0; i < profile->loop_count && i < PROFILE_TABLE_ROWS; ++i){
+        const LoopProfile* loop = &profile->loops[i];
+        char range[64];
+        snprintf(range, sizeof(range), "%d:%d-%d:%d", loop->line, loop->column, loop->end_line, loop->end_column);
+        printf("%-17s %12llu %12llu %12llu %6.1f%%\n", range, loop->steps, loop->iterations, loop->entries,
+               profile->steps ? 100.0 * (double)loop->steps / (double)profile->steps : 0.0);
+    }
+}
+
+void free_profile(Profile* profile){
+    free(profile->loops);
+    profile->loops = NULL;
+    profile->loop_count = 0;
+}
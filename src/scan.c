@@ -0,0 +1,98 @@
+#define _GNU_SOURCE // memrchr
+#include <string.h>
+
+#include "brainduck.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+Zero-search kernels for scan loops such as [>], [<] and [>>>>].
+
+A scan loop moves the stack pointer by a fixed stride until it lands
+on a zero cell. Bytes are searched with memchr/memrchr, which libc
+already vectorises. Other forward and backward strides that span a
+power of two bytes up to 16 are searched 16 bytes at a time with SSE2,
+and anything else falls back to a plain loop.
+*/
+
+#ifdef __SSE2__
+/* Returns a bit per byte of the 16 at p, set on the first byte of each zero cell */
+static unsigned int zero_cells(const char* p){
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i zero = _mm_setzero_si128();
+    switch(cell_shift){
+        case 1: v = _mm_cmpeq_epi16(v, zero); break;
+        case 2: v = _mm_cmpeq_epi32(v, zero); break;
+        default: v = _mm_cmpeq_epi8(v, zero); break;
+    }
+    return (unsigned int)_mm_movemask_epi8(v);
+}
+
+/* Repeats a bit every 'span' positions in a 16 bit mask, starting at bit 'first' */
+static unsigned int lane_mask(int span, int first){
+    unsigned int mask = 0;
+    int j;
+    for(j = first; j < 16; j += span) mask |= 1u << j;
+    return mask;
+}
+#endif
+
+/*
+Returns the first cell at or after p, stepping by 'stride' cells,
+that is zero, or the first cell of that sequence outside the stack.
+Cells are given as byte addresses and the result may lie outside the stack.
+*/
+static char* find_zero(char* p, long stride){
+    char* end = ctx->stack + (ctx->stack_size << cell_shift);
+    long step = stride << cell_shift; // bytes between cells visited
+    long bytes = 1L << cell_shift;
+
+    if (cell_shift == 0 && stride == 1){
+        char* found = memchr(p, 0, (size_t)(end - p));
+        return found ? found : end;
+    }
+    if (cell_shift == 0 && stride == -1){
+        char* found = memrchr(ctx->stack, 0, (size_t)(p - ctx->stack) + 1);
+        return found ? found : ctx->stack - 1;
+    }
+
+#ifdef __SSE2__
+    if (step > 0 && step <= 16 && (step & (step - 1)) == 0){
+        unsigned int mask = lane_mask((int)step, 0);
+        for(; end - p >= 16; p += 16){
+            unsigned int hits = zero_cells(p) & mask;
+            if (hits) return p + __builtin_ctz(hits);
+        }
+    }
+    else if (step < 0 && -step <= 16 && (-step & (-step - 1)) == 0){
+        unsigned int mask = lane_mask((int)-step, (int)(-step - bytes));
+        for(; p - ctx->stack >= 16 - bytes; p -= 16){
+            unsigned int hits = zero_cells(p + bytes - 16) & mask;
+            if (hits) return p + bytes - 16 + (31 - __builtin_clz(hits));
+        }
+    }
+#endif
+
+    while(p >= ctx->stack && p < end && get_cell(p) != 0) p += step;
+    return p;
+}
+
+/*
+Runs a scan loop from the stack pointer, charging the budget steps for
+each time it goes back round, as the loop it replaces would have.
+If the scan runs off the stack, a growable stack is extended to reach
+the next cell of the sequence, which is then zero.
+Otherwise returns ERR_BOUNDS, leaving the stack pointer at the edge it crossed.
+*/
+Error scan_stack(long stride, unsigned steps){
+    char* found = find_zero(ctx->stackptr, stride);
+    long offset = (found - ctx->stackptr) >> cell_shift;
+    if (steps > 0 && offset != 0 && charge_steps((unsigned long long)(offset / stride - 1) * steps) != ERR_OK){
+        return ERR_LIMIT;
+    }
+    if (check_cell(offset) != ERR_OK) return ERR_BOUNDS;
+    ctx->stackptr += offset << cell_shift;
+    return ERR_OK;
+}
@@ -0,0 +1,195 @@
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+/*
+Checkpoints of a running program, for --checkpoint and --resume.
+SIGUSR1 only sets a flag. The engines look at it when their budget
+runs out on a loop back-edge, which is when the state of the run is
+fully known: the loop about to go round again, the stack and its
+pointer, and how far input and output have got. The checkpoint holds
+all of these, with the stack written sparsely as its nonzero pages.
+
+A resumed run starts at the body of that loop, once the input already
+consumed has been skipped and the output moved to where it had got to,
+where input and output allow it.
+*/
+
+#define SNAPSHOT_MAGIC "BDSNAP1"
+#define SNAPSHOT_PAGE 4096 // bytes of stack per page
+#define SNAPSHOT_PATH_SIZE 4096
+
+const char* checkpoint_file = NULL; // where SIGUSR1 saves the state of the run, or NULL
+volatile sig_atomic_t checkpoint_requested = 0;
+
+typedef struct snapshot_header {
+    char magic[8];
+    unsigned long long key; // of the script and the options it was run with
+    int cell_shift;
+    int unused;
+    unsigned long long stack_size; // in cells
+    unsigned long long pos; // stack pointer, in cells
+    unsigned long long open; // instruction opening the loop that was about to go round
+    unsigned long long input_offset; // bytes of input consumed
+    unsigned long long output_offset; // bytes of output written
+    unsigned long long pages; // followed by this many page numbers, each with its contents
+} SnapshotHeader;
+
+static void request_checkpoint(int sig){
+    (void)sig;
+    checkpoint_requested = 1;
+}
+
+/* Has SIGUSR1 save a checkpoint of the running program */
+void watch_checkpoints(){
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_checkpoint;
+    action.sa_flags = SA_RESTART; // reads waiting for input carry on
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+}
+
+/* Bytes in page number page of a stack of size bytes */
+static size_t page_bytes(size_t size, size_t page){
+    size_t left = size - page * SNAPSHOT_PAGE;
+    return (left < SNAPSHOT_PAGE) ? left : SNAPSHOT_PAGE;
+}
+
+static int page_is_zero(const char* p, size_t n){
+    size_t i;
+    for(i = 0; i < n; ++i){
+        if (p[i] != 0) return 0;
+    }
+    return 1;
+}
+
+/*
+Saves the state of the current context to the checkpoint file, while
+the loop opened by instruction open is about to go round again.
+The file is written under a temporary name and renamed once complete,
+so a checkpoint is never left half written.
+*/
+void save_checkpoint(size_t open){
+    char tmp[SNAPSHOT_PATH_SIZE];
+    size_t bytes = ctx->stack_size << cell_shift;
+    size_t pages = (bytes + SNAPSHOT_PAGE - 1) / SNAPSHOT_PAGE;
+    SnapshotHeader header;
+    unsigned long long page;
+    int ok;
+    FILE* file;
+
+    checkpoint_requested = 0;
+    flush_output();
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.key = ctx->key;
+    header.cell_shift = cell_shift;
+    header.stack_size = ctx->stack_size;
+    header.pos = (unsigned long long)(ctx->stackptr - ctx->stack) >> cell_shift;
+    header.open = open;
+    header.input_offset = input_consumed();
+    header.output_offset = ctx->stats.bytes_out;
+    for(page = 0; page < pages; ++page){
+        if (!page_is_zero(ctx->stack + page * SNAPSHOT_PAGE, page_bytes(bytes, page))) header.pages++;
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", checkpoint_file, (long)getpid());
+    file = fopen(tmp, "wb");
+    if (!file) return;
+    ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for(page = 0; ok && page < pages; ++page){
+        const char* p = ctx->stack + page * SNAPSHOT_PAGE;
+        size_t n = page_bytes(bytes, page);
+        if (page_is_zero(p, n)) continue;
+        ok = fwrite(&page, sizeof(page), 1, file) == 1 && fwrite(p, 1, n, file) == n;
+    }
+    if (fclose(file) != 0) ok = 0;
+    if (!ok || rename(tmp, checkpoint_file) != 0) remove(tmp);
+}
+
+/* Skips the input a checkpointed run had consumed, seeking past it where the input allows */
+static void skip_input(unsigned long long offset){
+    char buf[INPUT_SIZE];
+    if (ctx->input_map){
+        ctx->input_pos = (offset < ctx->input_len) ? (size_t)offset : ctx->input_len;
+        return;
+    }
+    if (ctx->read == read_fd && lseek((int)(long)ctx->in, (off_t)offset, SEEK_SET) == (off_t)offset) return;
+    while(offset > 0){
+        long n = ctx->read(ctx->in, buf, (offset < sizeof(buf)) ? (size_t)offset : sizeof(buf));
+        if (n <= 0) break;
+        offset -= (unsigned long long)n;
+    }
+}
+
+/*
+Moves the output of a resumed run back to where the checkpoint left it.
+Output the run wrote to a file after the checkpoint was saved is cut
+off, so the file ends up as if the run had never stopped.
+*/
+static void rewind_output(unsigned long long offset){
+    struct stat st;
+    int fd;
+    if (ctx->write == write_fd) fd = (int)(long)ctx->out;
+    else if (ctx->write == write_file && fflush(ctx->out) == 0) fd = fileno(ctx->out);
+    else return;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (unsigned long long)st.st_size < offset) return;
+    if (ftruncate(fd, (off_t)offset) != 0) return;
+    if (ctx->write == write_fd) lseek(fd, (off_t)offset, SEEK_SET);
+    else fseek(ctx->out, (long)offset, SEEK_SET);
+}
+
+/*
+Restores the state saved in a checkpoint of the same script to the
+current context, and sets up run, a copy of the compiled program, to
+carry on from where it was. Returns ERR_FILE if the checkpoint cannot
+be read or belongs to another script or other options.
+*/
+Error resume_checkpoint(const char* filename, Program* run){
+    SnapshotHeader header;
+    size_t bytes;
+    unsigned long long i;
+    FILE* file = fopen(filename, "rb");
+
+    if (!file) return ERR_FILE;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+        || header.key != ctx->key || header.cell_shift != cell_shift || header.open >= run->len
+        || run->code[header.open].op != OP_OPEN || header.pos >= header.stack_size){
+        fclose(file);
+        return ERR_FILE;
+    }
+
+    // a growable stack may have grown before the checkpoint, which is saved from its first cell
+    ctx->stackptr = ctx->stack;
+    if (header.stack_size > ctx->stack_size && check_cell((long)header.stack_size - 1) != ERR_OK){
+        fclose(file);
+        return ERR_FILE;
+    }
+    bytes = (size_t)header.stack_size << cell_shift;
+    memset(ctx->stack, 0, ctx->stack_size << cell_shift);
+    touch_stack();
+    for(i = 0; i < header.pages; ++i){
+        unsigned long long page;
+        if (fread(&page, sizeof(page), 1, file) != 1 || page * SNAPSHOT_PAGE >= bytes) break;
+        if (fread(ctx->stack + page * SNAPSHOT_PAGE, 1, page_bytes(bytes, (size_t)page), file) != page_bytes(bytes, (size_t)page)) break;
+    }
+    fclose(file);
+    if (i < header.pages) return ERR_FILE;
+
+    ctx->stackptr = ctx->stack + ((size_t)header.pos << cell_shift);
+    skip_input(header.input_offset);
+    rewind_output(header.output_offset);
+    if (!ctx->input_map) ctx->input_total = header.input_offset; // a mapped file is in already, up to where it is skipped
+    ctx->stats.bytes_out = header.output_offset;
+
+    // carry on as if the loop had just gone round: into its body, after checking the block there
+    run->entry = (size_t)header.open + 1;
+    run->lo = run->code[header.open].lo;
+    run->hi = run->code[header.open].hi;
+    return ERR_OK;
+}
@@ -0,0 +1,89 @@
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+int stats_enabled = 0; // --stats is on, so that the JIT records where the stack pointer goes
+
+/*
+Statistics for --stats. The bytes of I/O and the span of the stack the
+stack pointer has been on cost the interpreters nothing to keep and are
+always gathered, while the JIT only records that span in code compiled
+for --stats. Counting instructions and loop iterations would slow down
+the interpreter loops, so it is only compiled in with STATS defined,
+and the JIT never counts.
+Hardware counters are read through perf_event_open around the run,
+where the kernel allows it.
+*/
+
+static const struct {
+    const char* name;
+    unsigned long long config;
+} hardware_events[STATS_EVENTS] = {
+    {"cycles", PERF_COUNT_HW_CPU_CYCLES},
+    {"branch_misses", PERF_COUNT_HW_BRANCH_MISSES},
+    {"cache_misses", PERF_COUNT_HW_CACHE_MISSES}
+};
+
+/* Clears the statistics of the current context and starts the hardware counters */
+void start_stats(){
+    Stats* stats = &ctx->stats;
+    int i;
+    memset(stats, 0, sizeof(Stats));
+    for(i = 0; i < STATS_EVENTS; ++i){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = hardware_events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        stats->counts[i] = -1;
+        stats->events[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0); // this thread, any processor
+        if (stats->events[i] >= 0){
+            ioctl(stats->events[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(stats->events[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+/* Stops the hardware counters and records the input consumed and the cells the stack pointer has been on */
+void stop_stats(){
+    Stats* stats = &ctx->stats;
+    int i;
+    for(i = 0; i < STATS_EVENTS; ++i){
+        long long count;
+        if (stats->events[i] < 0) continue;
+        ioctl(stats->events[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(stats->events[i], &count, sizeof(count)) == (long)sizeof(count)) stats->counts[i] = count;
+        close(stats->events[i]);
+        stats->events[i] = -1;
+    }
+    stats->bytes_in = input_consumed();
+    if (ctx->reached_lo){
+        stats->stack_lo = (long)((size_t)(ctx->reached_lo - ctx->stack) >> cell_shift) - (long)ctx->stack_origin;
+        stats->stack_hi = (long)((size_t)(ctx->reached_hi - ctx->stack) >> cell_shift) - (long)ctx->stack_origin + 1;
+    }
+}
+
+/* Writes the statistics of the current context, one 'name value' pair per line */
+void print_stats(FILE* out){
+    const Stats* stats = &ctx->stats;
+    int i;
+#ifdef STATS
+    fprintf(out, "instructions %llu\n", stats->steps);
+    fprintf(out, "loop_iterations %llu\n", stats->iterations);
+#endif
+    fprintf(out, "bytes_in %llu\n", stats->bytes_in);
+    fprintf(out, "bytes_out %llu\n", stats->bytes_out);
+    fprintf(out, "stack_cells %ld\n", stats->stack_hi - stats->stack_lo);
+    fprintf(out, "stack_high_water %ld\n", stats->stack_hi);
+    for(i = 0; i < STATS_EVENTS; ++i){
+        if (stats->counts[i] >= 0) fprintf(out, "%s %lld\n", hardware_events[i].name, stats->counts[i]);
+        else fprintf(out, "%s unavailable\n", hardware_events[i].name);
+    }
+}
@@ -0,0 +1,247 @@
+#include <pthread.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "brainduck.h"
+
+size_t tape_size = STACK_SIZE; // number of cells in a new stack
+int cell_shift = 0; // log2 of the bytes per cell
+int stack_growable = 0; // extend the stack on demand instead of failing
+int stack_guarded = 0; // surround the stack with inaccessible pages
+
+#define STACK_POOL_SIZE 64 // most unused stacks kept for reuse
+
+/* Zeroed stacks of tape_size cells left by destroyed contexts, shared by all threads */
+static char* stack_pool[STACK_POOL_SIZE];
+static int stack_pool_len = 0;
+static pthread_mutex_t stack_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static _Thread_local sigjmp_buf guard_jump; // where run_guarded resumes after a fault
+static _Thread_local volatile sig_atomic_t guard_armed = 0;
+
+/*
+Turns a fault on a guard page of the faulting thread's stack into a
+bounds error, leaving the stack pointer at the edge that was crossed.
+Any other fault is left to crash the program as usual.
+*/
+static void guard_handler(int sig, siginfo_t* info, void* context){
+    char* addr = (char*)info->si_addr;
+    (void)context;
+    if (!guard_armed || !ctx || addr < ctx->guard_region || addr >= ctx->guard_region + ctx->guard_region_size){
+        signal(sig, SIG_DFL); // the faulting instruction runs again and crashes
+        return;
+    }
+    ctx->stackptr = (addr < ctx->stack) ? ctx->stack : ctx->stack + ((ctx->stack_size - 1) << cell_shift);
+    guard_armed = 0;
+    siglongjmp(guard_jump, 1);
+}
+
+/*
+Returns how many cells below a guarded stack are covered by its guard pages.
+The stack ends on the upper guard, so unless its size is a whole number
+of pages, the start of the stack falls within a page that stays
+accessible, and cells below it have to be checked explicitly.
+*/
+int stack_guard_below(){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return ((tape_size << cell_shift) % page == 0) ? STACK_GUARD >> cell_shift : 0;
+}
+
+/*
+Maps the stack between two runs of STACK_GUARD inaccessible bytes.
+The mapping is rounded up to whole pages and the stack placed at its
+end, so that its last cell meets the upper guard.
+*/
+static Error init_guarded_stack(){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = ctx->stack_size << cell_shift;
+    size_t bytes = (size + page - 1) / page * page;
+    struct sigaction action;
+
+    ctx->guard_region_size = bytes + 2 * STACK_GUARD;
+    ctx->guard_region = mmap(NULL, ctx->guard_region_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ctx->guard_region == MAP_FAILED){
+        ctx->guard_region = NULL;
+        return ERR_UNKNOWN;
+    }
+    if (mprotect(ctx->guard_region + STACK_GUARD, bytes, PROT_READ | PROT_WRITE) != 0){
+        munmap(ctx->guard_region, ctx->guard_region_size);
+        ctx->guard_region = NULL;
+        return ERR_UNKNOWN;
+    }
+    ctx->stack = ctx->guard_region + STACK_GUARD + (bytes - size);
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = guard_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, NULL);
+    return ERR_OK;
+}
+
+/* Allocates a zeroed stack of the configured size for the current context, with the pointer on its first cell */
+Error init_stack(){
+    ctx->stack_size = tape_size;
+    if (stack_guarded){
+        if (init_guarded_stack() != ERR_OK) return ERR_UNKNOWN;
+    }
+    else{
+        pthread_mutex_lock(&stack_pool_lock);
+        ctx->stack = (stack_pool_len > 0) ? stack_pool[--stack_pool_len] : NULL;
+        pthread_mutex_unlock(&stack_pool_lock);
+        if (!ctx->stack) ctx->stack = calloc(ctx->stack_size > 0 ? ctx->stack_size : 1, (size_t)1 << cell_shift);
+        if (!ctx->stack) return ERR_UNKNOWN;
+    }
+    ctx->stackptr = ctx->stack;
+    ctx->touched_lo = ctx->touched_hi = 0;
+    return ERR_OK;
+}
+
+/* Frees the stack of the current context, or keeps it for the next one if it can be reused */
+void free_stack(){
+    if (ctx->guard_region){
+        munmap(ctx->guard_region, ctx->guard_region_size);
+        ctx->guard_region = NULL;
+    }
+    else if (ctx->stack){
+        int kept = 0;
+        if (ctx->stack_size == tape_size){
+            clear_stack();
+            pthread_mutex_lock(&stack_pool_lock);
+            if (stack_pool_len < STACK_POOL_SIZE){
+                stack_pool[stack_pool_len++] = ctx->stack;
+                kept = 1;
+            }
+            pthread_mutex_unlock(&stack_pool_lock);
+        }
+        if (!kept) free(ctx->stack);
+    }
+    ctx->stack = ctx->stackptr = NULL;
+}
+
+/*
+Records that cells from lo cells before low to hi cells after high,
+low and high being cell addresses, may have been written since the
+stack was last cleared.
+*/
+void touch_cells(const char* low, const char* high, long lo, long hi){
+    long first = ((low - ctx->stack) >> cell_shift) + lo;
+    long last = ((high - ctx->stack) >> cell_shift) + hi + 1;
+    if (first < 0) first = 0;
+    if (last > (long)ctx->stack_size) last = (long)ctx->stack_size;
+    if (first >= last) return;
+    if (ctx->touched_lo == ctx->touched_hi){
+        ctx->touched_lo = (size_t)first;
+        ctx->touched_hi = (size_t)last;
+        return;
+    }
+    if ((size_t)first < ctx->touched_lo) ctx->touched_lo = (size_t)first;
+    if ((size_t)last > ctx->touched_hi) ctx->touched_hi = (size_t)last;
+}
+
+/* Records that any cell may have been written */
+void touch_stack(){
+    ctx->touched_lo = 0;
+    ctx->touched_hi = ctx->stack_size;
+}
+
+/* Zeroes the cells written since the stack was last cleared, and moves the pointer back to the first cell */
+void clear_stack(){
+    memset(ctx->stack + (ctx->touched_lo << cell_shift), 0, (ctx->touched_hi - ctx->touched_lo) << cell_shift);
+    ctx->touched_lo = ctx->touched_hi = 0;
+    ctx->reached_lo = ctx->reached_hi = NULL;
+    ctx->stack_origin = 0;
+    ctx->stackptr = ctx->stack;
+}
+
+/*
+Runs an engine, turning faults on the guard pages into ERR_BOUNDS.
+Without guard pages, the engine is simply called.
+*/
+Error run_guarded(Error (*run)(const void*), const void* arg){
+    Error err;
+    if (!stack_guarded) return run(arg);
+    if (sigsetjmp(guard_jump, 1)){
+        touch_stack(); // the engine stopped before recording what it wrote
+        return ERR_BOUNDS;
+    }
+    guard_armed = 1;
+    err = run(arg);
+    guard_armed = 0;
+    return err;
+}
+
+/*
+Extends the stack so that it reaches cell pos, counted from the current
+start of the stack, which may be negative. The stack at least doubles
+in size every time, so growth costs amortised constant time per cell.
+Cells added below the start shift the existing ones up, and the extremes
+of the stack pointer kept in the context move along with them.
+*/
+static Error grow_stack(long pos){
+    size_t index = (size_t)(ctx->stackptr - ctx->stack) >> cell_shift;
+    size_t need = (pos < 0) ? (size_t)(-pos) : (size_t)pos - ctx->stack_size + 1;
+    size_t extra = (need > ctx->stack_size) ? need : ctx->stack_size;
+    size_t shift = (pos < 0) ? extra : 0; // cells the existing ones move up by
+    size_t reached_lo = 0, reached_hi = 0; // cells the stack pointer has been on
+    char* grown;
+    if (ctx->reached_lo){
+        reached_lo = ((size_t)(ctx->reached_lo - ctx->stack) >> cell_shift) + shift;
+        reached_hi = ((size_t)(ctx->reached_hi - ctx->stack) >> cell_shift) + shift;
+    }
+    grown = realloc(ctx->stack, (ctx->stack_size + extra) << cell_shift);
+    if (!grown) return ERR_BOUNDS;
+    if (ctx->reached_lo){
+        ctx->reached_lo = grown + (reached_lo << cell_shift);
+        ctx->reached_hi = grown + (reached_hi << cell_shift);
+    }
+    if (pos < 0){
+        memmove(grown + (extra << cell_shift), grown, ctx->stack_size << cell_shift);
+        memset(grown, 0, extra << cell_shift);
+        index += extra;
+    }
+    else{
+        memset(grown + (ctx->stack_size << cell_shift), 0, extra << cell_shift);
+    }
+    ctx->stack = grown;
+    ctx->stack_size += extra;
+    ctx->stack_origin += shift;
+    touch_stack(); // cells may have moved
+    ctx->stackptr = ctx->stack + (index << cell_shift);
+    return ERR_OK;
+}
+
+/*
+Ensures that the cell at offset from the stack pointer exists.
+A growable stack is extended to reach it, which may move the stack.
+Otherwise returns ERR_BOUNDS, leaving the stack pointer at the edge it crossed.
+*/
+Error check_cell(long offset){
+    long pos = ((ctx->stackptr - ctx->stack) >> cell_shift) + offset;
+    if (pos >= 0 && pos < (long)ctx->stack_size) return ERR_OK;
+    if (stack_growable && grow_stack(pos) == ERR_OK) return ERR_OK;
+    ctx->stackptr = (pos < 0) ? ctx->stack : ctx->stack + ((ctx->stack_size - 1) << cell_shift);
+    return ERR_BOUNDS;
+}
+
+/* Reads the cell at p, whatever the cell width. Engines built for one width access cells directly. */
+unsigned long get_cell(const char* p){
+    switch(cell_shift){
+        case 1: return *(const uint16_t*)p;
+        case 2: return *(const uint32_t*)p;
+        default: return *(const uint8_t*)p;
+    }
+}
+
+/* Writes the cell at p, wrapping the value around to the cell width */
+void set_cell(char* p, unsigned long value){
+    switch(cell_shift){
+        case 1: *(uint16_t*)p = (uint16_t)value; break;
+        case 2: *(uint32_t*)p = (uint32_t)value; break;
+        default: *(uint8_t*)p = (uint8_t)value; break;
+    }
+}
@@ -0,0 +1,33 @@
+#include <string.h>
+
+#include "brainduck.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/*
+Vector kernel for dense blocks, which add a constant pattern to a run of
+neighbouring cells. The pattern is laid out as cells of the current width,
+so whole 16 byte chunks are added at once and carries never cross cells.
+*/
+void add_cells(char* dst, const char* deltas, size_t count){
+    size_t bytes = count << cell_shift, i = 0;
+
+#ifdef __SSE2__
+    for(; i + 16 <= bytes; i += 16){
+        __m128i v = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(deltas + i));
+        switch(cell_shift){
+            case 1: v = _mm_add_epi16(v, d); break;
+            case 2: v = _mm_add_epi32(v, d); break;
+            default: v = _mm_add_epi8(v, d); break;
+        }
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+#endif
+
+    for(; i < bytes; i += (size_t)1 << cell_shift){
+        set_cell(dst + i, get_cell(dst + i) + get_cell(deltas + i));
+    }
+}
@@ -0,0 +1,106 @@
+# Regression tests, run by 'sh make.sh test'.
+# Each case runs a script on every engine and compares the exit code and output with the expected ones.
+
+BIN=${1:-./brainduck}
+TMP=${TMPDIR:-/tmp}/brainduck-tests.$$
+ENGINES="--naive|-|--no-optimize|--jit|--guard-pages|--guard-pages --jit"
+failed=0
+mkdir -p "$TMP"
+trap 'rm -rf "$TMP"' EXIT
+
+# check NAME EXIT_CODE OUTPUT SCRIPT [OPTIONS...], with the input of the script on stdin
+check(){
+    name=$1 code=$2 expected=$3 script=$4
+    shift 4
+    printf '%s' "$script" > "$TMP/script.bf"
+    cat > "$TMP/input"
+    IFS='|'
+    for engine in $ENGINES; do
+        IFS=' '
+        [ "$engine" = "-" ] && engine=""
+        output=$("$BIN" "$TMP/script.bf" $engine "$@" < "$TMP/input" 2>&1)
+        got=$?
+        if [ "$got" != "$code" ] || [ "$output" != "$expected" ]; then
+            echo "FAIL $name [$engine]: exit $got, output '$output'"
+            failed=1
+        fi
+        IFS='|'
+    done
+    IFS=' '
+}
+
+BOUNDS="Error: stack pointer out of bounds"
+
+# a scan that does not run still checks the block after it
+check zero-scan-then-left 3 "$BOUNDS" ",[>]<<+" < /dev/null
+check zero-scan-then-right 3 "$BOUNDS" ",[<]>>>>+" --tape-size=4 < /dev/null
+check zero-scan-in-loop 3 "$BOUNDS" "+[;[>]<--;+]" < /dev/null
+check zero-scan-then-grow 0 "" ",[>]<<+" --grow --tape-size=3 < /dev/null
+
+# every engine counts the same steps: the 9 commands of the loop, each time round
+LIMIT="Error: execution limit exceeded"
+check steps-at-limit 0 "50" "++++++++++[>+++++<-   (a comment)   ]>:" --max-steps=81 < /dev/null
+check steps-over-limit 6 "$LIMIT" "++++++++++[>+++++<-   (a comment)   ]>:" --max-steps=80 < /dev/null
+
+# collapsed loops count the steps of every time round: 254 of [-] at 2 steps, then 4 at 13
+check collapsed-at-limit 0 "45" "-[-]+++++[>+++++++++<-]>:" --max-steps=560 < /dev/null
+check collapsed-over-limit 6 "$LIMIT" "-[-]+++++[>+++++++++<-]>:" --max-steps=559 < /dev/null
+
+# --stats reports the cells the stack pointer went over, the same on every engine
+printf '>>+<<++++[>++++<-]>[>>+<<-]' > "$TMP/script.bf"
+IFS='|'
+for engine in $ENGINES; do
+    IFS=' '
+    [ "$engine" = "-" ] && engine=""
+    "$BIN" "$TMP/script.bf" $engine --stats="$TMP/stats" > /dev/null
+    if [ "$(grep '^stack_' "$TMP/stats" | tr '\n' ' ')" != "stack_cells 4 stack_high_water 4 " ]; then
+        echo "FAIL stack-stats [$engine]: $(grep '^stack_' "$TMP/stats" | tr '\n' ' ')"
+        failed=1
+    fi
+    IFS='|'
+done
+IFS=' '
+
+# input mapped with --input counts as it is consumed, for --stats and for checkpoints
+printf 'abcdef' > "$TMP/mapped"
+printf ',.,.,.' > "$TMP/script.bf"
+"$BIN" "$TMP/script.bf" --stream --input="$TMP/mapped" --stats="$TMP/stats" > /dev/null
+if ! grep -qx "bytes_in 3" "$TMP/stats"; then
+    echo "FAIL input-stats: $(grep bytes_in "$TMP/stats")"
+    failed=1
+fi
+# reads two bytes, loops long enough to be checkpointed, then reads two more
+printf ',.,.>>++++[>-[>-[>-[>+>[-]<<-]<-]<-]<-]<<,.,.' > "$TMP/script.bf"
+rm -f "$TMP/snap"
+"$BIN" "$TMP/script.bf" --stream --input="$TMP/mapped" --stats="$TMP/stats" --checkpoint="$TMP/snap" > "$TMP/output" &
+sleep 0.3
+kill -USR1 $!
+wait $!
+"$BIN" "$TMP/script.bf" --stream --input="$TMP/mapped" --resume="$TMP/snap" >> "$TMP/output"
+if [ ! -f "$TMP/snap" ] || [ "$(cat "$TMP/output")" != "abcd" ]; then
+    echo "FAIL input-resume: output '$(cat "$TMP/output")'"
+    failed=1
+fi
+
+# cache entries anyone else can write to are ignored, and so is a cache directory they can write to
+printf '++++++++[>++++++<-]>.' > "$TMP/script.bf"
+mkdir -m 700 "$TMP/cache"
+"$BIN" "$TMP/script.bf" --jit --cache="$TMP/cache" > /dev/null
+for entry in "$TMP"/cache/*; do
+    printf 'x' > "$entry"
+    chmod 666 "$entry"
+done
+output=$("$BIN" "$TMP/script.bf" --jit --cache="$TMP/cache")
+if [ "$output" != "0" ]; then
+    echo "FAIL cache-writable-entry: output '$output'"
+    failed=1
+fi
+mkdir -m 770 "$TMP/shared"
+"$BIN" "$TMP/script.bf" --jit --cache="$TMP/shared" > /dev/null
+if [ -n "$(ls "$TMP/shared")" ]; then
+    echo "FAIL cache-writable-dir: $(ls "$TMP/shared")"
+    failed=1
+fi
+
+if [ $failed = 0 ]; then echo "All tests passed"; fi
+exit $failed